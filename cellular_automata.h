@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <tuple>
 #include <cmath>
@@ -13,154 +14,174 @@ namespace corgi { namespace ca {
 
 
 
-/// Moore neighborhood of different dimensions
-// using SFINAE to pick dimensionality specialization
-
-template<std::size_t D, typename T = std::enable_if_t<(D==1),int> >
-std::vector< corgi::internals::tuple_of<D, T> > moore_neighborhood()
+//--------------------------------------------------
+// compile-time stencils
+//
+// Stencils are std::arrays of relative offsets (std::array<int,D>) that
+// are generated at compile time for any dimension D and radius R.
+// Offsets are ordered so that the first index runs fastest and the
+// center (0,...,0) is always excluded.
+
+/// relative offset of a neighbor
+template<std::size_t D>
+using offset_t = std::array<int, D>;
+
+/// supported stencil shapes
+enum class stencil_shape {
+  von_neumann, ///< Manhattan distance |r|_1 <= R
+  chessboard,  ///< Chebyshev distance |r|_inf <= R (Moore neighborhood)
+  euclidean    ///< Euclidean distance |r|_2 < R
+};
+
+
+/// number of cells in the bounding box [-R, R]^D
+template<std::size_t D>
+constexpr std::size_t box_volume(int radius)
 {
-  std::vector<  corgi::internals::tuple_of<D,int> > ret = {
-    {std::make_tuple(-1), std::make_tuple(+1)}
-  };
-  return ret;
+  std::size_t n = 1;
+  for(std::size_t i=0; i<D; i++) n *= static_cast<std::size_t>(2*radius + 1);
+  return n;
 }
 
-
-template<std::size_t D, typename T = std::enable_if_t<(D==2),int> >
-std::vector< corgi::internals::tuple_of<2,int> > moore_neighborhood()
+/// n:th offset inside the bounding box [-R, R]^D 
+template<std::size_t D>
+constexpr offset_t<D> box_offset(std::size_t n, int radius)
 {
-  //std::vector<  corgi::internals::tuple_of<2,int> > ret = {
-  //  { std::make_tuple(-1, -1), 
-  //    std::make_tuple(-1,  0), 
-  //    std::make_tuple(-1, +1), 
-  //    std::make_tuple( 0, +1), 
-  //    std::make_tuple(+1, +1), 
-  //    std::make_tuple( 0, +1), 
-  //    std::make_tuple(+1, -1), 
-  //    std::make_tuple( 0, -1) }
-  //};
-  std::vector<  corgi::internals::tuple_of<2,int> > ret;
-  ret.reserve(8);
-  for (int jr=-1; jr<=1; jr++) {
-    for (int ir=-1; ir<=1; ir++) {
-      if (!( ir == 0 && jr == 0  )) {
-        ret.emplace_back(ir, jr );
-      }
-    }
+  offset_t<D> rel{};
+  auto width = static_cast<std::size_t>(2*radius + 1);
+  for(std::size_t i=0; i<D; i++) {
+    rel[i] = static_cast<int>(n % width) - radius;
+    n /= width;
   }
-  return ret;
+  return rel;
 }
 
-template<std::size_t D, typename T = std::enable_if_t<(D==3),int> >
-std::vector< corgi::internals::tuple_of<3,int> > moore_neighborhood()
+/// is the relative offset part of the stencil
+template<std::size_t D>
+constexpr bool in_stencil(stencil_shape shape, int radius, const offset_t<D>& rel)
 {
-  std::vector<  corgi::internals::tuple_of<3,int> > ret;
-  ret.reserve(26);
-  for (int kr=-1; kr<=1; kr++) {
-    for (int jr=-1; jr<=1; jr++) {
-      for (int ir=-1; ir<=1; ir++) {
-        if (!( ir == 0 && jr == 0 && kr == 0 )) {
-          ret.emplace_back(ir, jr, kr );
-        }
-      }
-    }
+  int l1 = 0, linf = 0, l2 = 0;
+  for(std::size_t i=0; i<D; i++) {
+    int a = rel[i] < 0 ? -rel[i] : rel[i];
+    l1 += a;
+    l2 += a*a;
+    if(a > linf) linf = a;
   }
-  return ret;
-}
 
+  if(l1 == 0) return false; // center
 
-// Box distances
-//--------------------------------------------------
-template<std::size_t D, typename T = std::enable_if_t<(D==1),int> >
-std::vector< corgi::internals::tuple_of<1,int> > chessboard_neighborhood(int radius)
-{
-  std::vector<  corgi::internals::tuple_of<1,int> > ret;
-  for (int ir=-radius; ir<=radius; ir++) {
-    if (!( ir == 0 )) {
-      ret.emplace_back(ir );
-    }
+  switch(shape) {
+    case stencil_shape::von_neumann: return l1   <= radius;
+    case stencil_shape::chessboard:  return linf <= radius;
+    case stencil_shape::euclidean:   return l2   <  radius*radius;
   }
-  return ret;
+  return false;
 }
 
-
-template<std::size_t D, typename T = std::enable_if_t<(D==2),int> >
-std::vector< corgi::internals::tuple_of<2,int> > chessboard_neighborhood(int radius)
+/// number of neighbors in the stencil
+template<std::size_t D>
+constexpr std::size_t stencil_size(stencil_shape shape, int radius)
 {
-  std::vector<  corgi::internals::tuple_of<2,int> > ret;
-  for (int jr=-radius; jr<=radius; jr++) {
-    for (int ir=-radius; ir<=radius; ir++)  {
-      if (!( ir == 0 && jr == 0 )) {
-        ret.emplace_back(ir, jr );
-      }
-    }
+  std::size_t n = 0;
+  for(std::size_t k=0; k<box_volume<D>(radius); k++) {
+    if(in_stencil<D>(shape, radius, box_offset<D>(k, radius))) n++;
   }
-  return ret;
+  return n;
 }
 
-template<std::size_t D, typename T = std::enable_if_t<(D==3),int> >
-std::vector< corgi::internals::tuple_of<3,int> > chessboard_neighborhood(int radius)
+/// compile-time table of relative offsets
+template<std::size_t D, stencil_shape S, int R>
+constexpr std::array<offset_t<D>, stencil_size<D>(S, R)> make_stencil()
 {
-  std::vector<  corgi::internals::tuple_of<3,int> > ret;
-  for (int kr=-radius; kr<=radius; kr++) {
-    for (int jr=-radius; jr<=radius; jr++) {
-      for (int ir=-radius; ir<=radius; ir++)  {
-        if (!( ir == 0 && jr == 0 && kr == 0)) {
-          ret.emplace_back(ir, jr, kr );
-        }
-      }
-    }
+  std::array<offset_t<D>, stencil_size<D>(S, R)> ret{};
+
+  std::size_t n = 0;
+  for(std::size_t k=0; k<box_volume<D>(R); k++) {
+    auto rel = box_offset<D>(k, R);
+    if(in_stencil<D>(S, R, rel)) ret[n++] = rel;
   }
   return ret;
 }
 
-// Spherical distances
-//--------------------------------------------------
-template<std::size_t D, typename T = std::enable_if_t<(D==1),int> >
-std::vector< corgi::internals::tuple_of<1,int> > euler_neighborhood(int radius)
-{
-  return chessboard_neighborhood<1>(radius);
-}
+/// von Neumann (diamond) stencil
+template<std::size_t D, int R = 1>
+constexpr auto von_neumann_stencil() { return make_stencil<D, stencil_shape::von_neumann, R>(); }
 
+/// chessboard (box) stencil
+template<std::size_t D, int R = 1>
+constexpr auto chessboard_stencil() { return make_stencil<D, stencil_shape::chessboard, R>(); }
 
-template<std::size_t D, typename T = std::enable_if_t<(D==2),int> >
-std::vector< corgi::internals::tuple_of<2,int> > euler_neighborhood(int radius)
+/// Euclidean (sphere) stencil
+template<std::size_t D, int R = 1>
+constexpr auto euclidean_stencil() { return make_stencil<D, stencil_shape::euclidean, R>(); }
+
+/// Moore neighborhood; chessboard stencil of radius 1
+template<std::size_t D>
+constexpr auto moore_stencil() { return chessboard_stencil<D, 1>(); }
+
+/// number of tiles in the Moore neighborhood (3^D - 1)
+template<std::size_t D>
+constexpr std::size_t moore_size()
 {
-  std::vector<  corgi::internals::tuple_of<2,int> > ret;
-  for (int jr=-radius; jr<=radius; jr++) {
-    for (int ir=-radius; ir<=radius; ir++) {
+  return box_volume<D>(1) - 1;
+}
 
-      auto rel = std::make_tuple(ir,jr);
-      if( ::corgi::geom::eulerian_distance<D>(rel) >= (double)radius ) continue;
 
-      if (!( ir == 0 && jr == 0 )) {
-        ret.push_back( rel );
-      }
-    }
+//--------------------------------------------------
+// run-time neighborhoods 
+//
+// Same shapes for radii that are known only at run-time; returned as 
+// vectors of tuples.
+
+template<std::size_t D>
+std::vector< corgi::internals::tuple_of<D, int> > 
+stencil_neighborhood(stencil_shape shape, int radius)
+{
+  std::vector< corgi::internals::tuple_of<D, int> > ret;
+  for(std::size_t k=0; k<box_volume<D>(radius); k++) {
+    auto rel = box_offset<D>(k, radius);
+    if(in_stencil<D>(shape, radius, rel)) ret.push_back( corgi::internals::into_tuple(rel) );
   }
   return ret;
 }
 
-template<std::size_t D, typename T = std::enable_if_t<(D==3),int> >
-std::vector< corgi::internals::tuple_of<3,int> > euler_neighborhood(int radius)
+/// Moore neighborhood 
+template<std::size_t D>
+std::vector< corgi::internals::tuple_of<D, int> > moore_neighborhood()
 {
-  std::vector<  corgi::internals::tuple_of<3,int> > ret;
-  for (int kr=-radius; kr<=radius; kr++) {
-    for (int jr=-radius; jr<=radius; jr++) {
-      for (int ir=-radius; ir<=radius; ir++) {
-
-        auto rel = std::make_tuple(ir,jr,kr);
-        if( ::corgi::geom::eulerian_distance<D>(rel) >= (double)radius ) continue;
-
-        if (!( ir == 0 && jr == 0 && kr == 0)) {
-          ret.push_back( rel );
-        }
-      }
-    }
-  }
+  constexpr auto stencil = moore_stencil<D>();
+
+  std::vector< corgi::internals::tuple_of<D, int> > ret;
+  ret.reserve(stencil.size());
+  for(auto& rel : stencil) ret.push_back( corgi::internals::into_tuple(rel) );
   return ret;
 }
 
+// Box distances
+template<std::size_t D>
+std::vector< corgi::internals::tuple_of<D, int> > chessboard_neighborhood(int radius)
+{
+  return stencil_neighborhood<D>(stencil_shape::chessboard, radius);
+}
+
+// Diamond distances
+template<std::size_t D>
+std::vector< corgi::internals::tuple_of<D, int> > von_neumann_neighborhood(int radius)
+{
+  return stencil_neighborhood<D>(stencil_shape::von_neumann, radius);
+}
+
+// Spherical distances
+//
+// NOTE: in 1D this is the closed interval |r| <= R (same as the 
+// chessboard neighborhood), not the strict |r| < R of higher dimensions.
+template<std::size_t D>
+std::vector< corgi::internals::tuple_of<D, int> > euler_neighborhood(int radius)
+{
+  if constexpr (D == 1) return chessboard_neighborhood<D>(radius);
+
+  return stencil_neighborhood<D>(stencil_shape::euclidean, radius);
+}
 
 
 
@@ -111,10 +111,45 @@ namespace commType {
         NTILES,   //! Number of incoming tiles,
         TILEDATA, //! Tile data array
         ADOPT,
+        COUNCIL_MOVES,  //! Ownership changes of the distributed council
+        COUNCIL_OWNERS, //! Owners around adopted tiles
         N_COMMTYPES
     };
 }
 
+/*! How Grid::send_data/recv_data move tile data.
+ *
+ * PER_TILE:   every tile posts its own messages via Tile::send_data/recv_data
+ * AGGREGATED: tiles serialize via Tile::pack_data/unpack_data and the grid
+ *             sends one message per neighbor rank
+ * HALO:       as AGGREGATED but only the regions that the neighbors read are
+ *             sent, via Tile::pack_halo/unpack_halo
+ */
+namespace exchangeType {
+    enum {
+        PER_TILE,
+        AGGREGATED,
+        HALO,
+        N_EXCHANGETYPES
+    };
+}
+
+/*! How aggregated tile data (exchangeType::AGGREGATED/HALO) moves between ranks.
+ *
+ * POINT_TO_POINT:      one (persistent if possible) message per neighbor rank
+ * NEIGHBOR_COLLECTIVE: one MPI_Ineighbor_alltoallv over a graph communicator
+ * ONE_SIDED:           MPI_Put into receiver windows, synchronized with
+ *                      post-start-complete-wait; needs fixed-size payloads
+ */
+namespace transportType {
+    enum {
+        POINT_TO_POINT,
+        NEIGHBOR_COLLECTIVE,
+        ONE_SIDED,
+        N_TRANSPORTTYPES
+    };
+}
+
 
 
 
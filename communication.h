@@ -33,7 +33,7 @@ inline MPI_Datatype get_mpi_datatype<corgi::Communication>(
   //--------------------------------------------------
   // Communication class interiors:
   //
-  // 1 int cid;
+  // 1 uint64_t cid;
   // 2 std::array<int, 3> indices;
   // 3 int owner;
   // 4 int top_virtual_owner;
@@ -81,7 +81,7 @@ inline MPI_Datatype get_mpi_datatype<corgi::Communication>(
 
   // introduce datatypes
   std::array<MPI_Datatype, 8> datatypes{
-    { MPI_INT, MPI_INT, MPI_INT, MPI_INT, MPI_INT, MPI_INT, MPI_DOUBLE, MPI_DOUBLE }
+    { MPI_UINT64_T, MPI_INT, MPI_INT, MPI_INT, MPI_INT, MPI_INT, MPI_DOUBLE, MPI_DOUBLE }
   };
 
   //--------------------------------------------------
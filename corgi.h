@@ -11,13 +11,23 @@
 #include <cmath>
 #include <memory>
 #include <unordered_map>
+#include <typeindex>
+#include <functional>
 #include <cassert>
 #include <initializer_list>
 #include <sstream>
+#include <stdexcept>
 #include <utility>
+#include <limits>
 
 #include "internals.h"
+#include "indexing.h"
+#include "fwd_corgi.h"
 #include "toolbox/sparse_grid.h"
+#include "toolbox/dense_grid.h"
+#include "toolbox/tile_store.h"
+#include "toolbox/byte_stream.h"
+#include "toolbox/sparse_exchange.h"
 #include "tile.h"
 
 //#include "mpi.h"
@@ -29,13 +39,28 @@ namespace corgi {
 
 
 /*! Individual grid object that stores patches of grid in it.
+ *
+ * Storage template selects the container used for the global 
+ * ownership (_mpi_grid) and work (_work_grid) grids. Default is the 
+ * flat corgi::tools::dense_grid; corgi::tools::sparse_grid can be used 
+ * for grids that are only partially filled.
+ *
+ * Ordering template selects the tile ID engine (see indexing.h). Default 
+ * is the linear (column-major) ordering; corgi::indexing::morton and 
+ * corgi::indexing::hilbert give space-filling-curve IDs so that sorted 
+ * tile lists (and hence storage and communication order) follow spatial 
+ * locality.
  *
  * See:
  * - https://github.com/maddouri/hyper_array/
  * - https://github.com/astrobiology/orca_array
 */
 
-template<std::size_t D>
+template<
+  std::size_t D,
+  template<typename, int> class Storage,
+  template<std::size_t> class Ordering
+  >
 class Grid
 {
 
@@ -48,6 +73,13 @@ class Grid
   using index_type = std::size_t;
   using float_type = double;
 
+  /// container type of the global grids
+  template<typename T>
+  using storage_type = Storage<T, D>;
+
+  /// tile ID engine
+  using ordering_type = Ordering<D>;
+
 
   protected:
 
@@ -64,11 +96,11 @@ class Grid
   /*! Global large scale block grid where information
    * of all the mpi processes are stored
    */
-  corgi::tools::sparse_grid<int, D> _mpi_grid;
+  storage_type<int> _mpi_grid;
 
   /// global large scale block grid where load balance 
   //information is stored
-  corgi::tools::sparse_grid<double, D> _work_grid;
+  storage_type<double> _work_grid;
 
   // --------------------------------------------------
   private:
@@ -77,14 +109,94 @@ class Grid
   using TileID_t = uint64_t;
   using Tile_t   = corgi::Tile<D>;
   using Tileptr  = std::shared_ptr<Tile_t>;
-  using Tile_map = std::unordered_map<TileID_t, Tileptr>;
+  using Tile_store = corgi::tools::tile_store<Tile_t>;
+
+
+
+  public:
+
+  /// Storage of tile_id & tile data 
+  //
+  // NOTE: supports the std::unordered_map interface that was used before
+  // together with O(1) cid -> handle and handle -> raw pointer look-ups.
+  Tile_store tiles;
+
+
+  private:
+
+  /// retired tiles, binned by their dynamic type, waiting to be re-used
+  std::unordered_map<std::type_index, std::vector<Tileptr>> _tile_pool;
+
+  /// Put tile into the pool if nobody else holds a reference to it
+  void _retire_tile(Tileptr tileptr)
+  {
+    if(tileptr.use_count() != 1) return;
+    auto& bin = _tile_pool[ std::type_index(typeid(*tileptr)) ];
+    bin.push_back( std::move(tileptr) );
+  }
+
+
+  public:
+
+  /*! \brief Get a new tile of type T
+   *
+   * Retired tiles of the same type are recycled (see Tile::recycle) 
+   * before any new memory is allocated.
+   */
+  template<typename T = Tile_t>
+  std::shared_ptr<T> make_tile()
+  {
+    auto it = _tile_pool.find( std::type_index(typeid(T)) );
+    if(it == _tile_pool.end() || it->second.empty()) return std::make_shared<T>();
+
+    auto tileptr = std::static_pointer_cast<T>( std::move(it->second.back()) );
+    it->second.pop_back();
+    tileptr->recycle();
+
+    return tileptr;
+  }
+
+  /// Signature of user-defined tile factories used by create_tile
+  //
+  // Factory receives the grid (for make_tile) and the metainfo of the 
+  // incoming tile; metainfo is loaded into the tile afterwards.
+  using Tile_factory = std::function<Tileptr(Grid&, const Communication&)>;
+
+
+  private:
 
+  /// factory for incoming tiles; bare Tile_t if empty
+  Tile_factory _tile_factory;
 
 
   public:
 
-  /// Map with tile_id & tile data
-  Tile_map tiles;
+  /// Register factory that builds incoming (virtual) tiles
+  void set_tile_factory(Tile_factory factory) 
+  { 
+    _tile_factory = std::move(factory); 
+  }
+
+  /// Build incoming tiles as default-constructed T
+  template<typename T>
+  void set_tile_type()
+  {
+    _tile_factory = [](Grid& grid, const Communication& /*cm*/) -> Tileptr 
+    { 
+      return grid.template make_tile<T>(); 
+    };
+  }
+
+  /// number of retired tiles waiting for re-use
+  size_t tile_pool_size() const
+  {
+    size_t n = 0;
+    for(auto&& bin : _tile_pool) n += bin.second.size();
+    return n;
+  }
+
+  /// release memory of all retired tiles
+  void clear_tile_pool() { _tile_pool.clear(); }
 
 
   public:
@@ -107,6 +219,9 @@ class Grid
   corgi::internals::are_integral<Indices...>::value, void > 
   py_set_mpi_grid(int val, Indices... indices) {
     _mpi_grid(indices...) = val;
+    _nhoods_dirty = true;
+    _frontier_dirty = true;
+    _loads_dirty = true;
   }
 
 
@@ -125,6 +240,7 @@ class Grid
   corgi::internals::are_integral<Indices...>::value, void > 
   py_set_work_grid(double val, Indices... indices) {
     _work_grid(indices...) = val;
+    _loads_dirty = true;
   }
 
 
@@ -139,10 +255,14 @@ class Grid
   /// mpi communicator
   mpi::communicator comm;
     
-  /// Uninitialized dimension lengths
+  /// Empty grid; dimension lengths and grid limits are zero
   Grid() :
+    _lengths{},
+    _mins{},
+    _maxs{},
     env(),
-    comm()
+    comm(),
+    _indexer(_lengths)
   {};
    
   /// set dimensions during construction time
@@ -154,15 +274,37 @@ class Grid
   > 
   Grid(DimensionLength... dimension_lengths) :
     _lengths {{static_cast<size_type>(dimension_lengths)...}},
+    _mins{},
+    _maxs{},
     _mpi_grid(dimension_lengths...),
     _work_grid(dimension_lengths...),
     env(),
-    comm()
+    comm(),
+    _indexer(_lengths)
   { }
   
 
   /// Deallocate and free everything
-  virtual ~Grid() = default;
+  //
+  // Windows and communicators of the data exchange are freed collectively, 
+  // so all ranks have to destroy their grids together (before MPI_Finalize).
+  virtual ~Grid()
+  {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if(finalized) return;
+
+    _free_plans();
+    for(auto& elem : _windows)     _free_window(elem.second);
+    for(auto& elem : _shm_windows) _free_shm_window(elem.second);
+
+    if(_graph_comm != MPI_COMM_NULL) MPI_Comm_free(&_graph_comm);
+    if(_node_comm  != MPI_COMM_NULL) MPI_Comm_free(&_node_comm);
+  }
+
+  /// grid owns MPI handles; not copyable
+  Grid(const Grid&) = delete;
+  Grid& operator=(const Grid&) = delete;
 
   public:
 
@@ -236,7 +378,13 @@ class Grid
   // --------------------------------------------------
   // indexing
   private:
+
+  /// tile ID engine; caches everything that depends on grid dimensions
+  ordering_type _indexer;
   
+  /// Check index ranges
+  //
+  // NOTE: validation is only done in debug builds (i.e., without NDEBUG)
   template <typename... Indices>
   corgi::internals::enable_if_t< (sizeof...(Indices) == D) && 
   corgi::internals::are_integral<Indices...>::value,
@@ -245,6 +393,7 @@ class Grid
   {
     ::std::array<index_type, D> index_array = {{static_cast<index_type>(indices)...}};
 
+#ifndef NDEBUG
     // check all indices and prepare an exhaustive report (in oss)
     // if some of them are out of bounds
     std::ostringstream oss;
@@ -262,62 +411,9 @@ class Grid
 
     // if nothing has been written to oss then all indices are valid
     assert(oss.str().empty());
-    return index_array;
-  }
-
-  /*! Computes the index coefficients assuming column-major order
-   *
-   *  what we compute:
-   *        \f[
-   *            \begin{cases}
-   *            C_i = \prod_{j=i+1}^{n-1} L_j
-   *            \\
-   *            \begin{cases}
-   *                i   &\in [0, \text{Dimensions - 1}] \\
-   *                C_i &: \text{\_coeffs[i]}           \\
-   *                L_j &: \text{\_lengths[j]}
-   *            \end{cases}
-   *            \end{cases}
-   *        \f]
-   *
-   *  For row-major switch to:
-   *  coeffs[i] = ct_accumulate(dimension_lengths, i + 1, Dimensions - i - 1,
-   *                                        static_cast<size_type>(1),
-   *                                        ct_prod<size_type>);
-   *
-   */
-  std::array<size_type, D>
-  compute_index_coeffs(const ::std::array<size_type, D>& dimension_lengths) const noexcept
-  {
-      std::array<size_type, D> coeffs;
-      for (size_type i = 0; i < D; ++i)
-      {
-          coeffs[i] = corgi::internals::ct_accumulate(
-              dimension_lengths,
-              0,
-              i,
-              static_cast<size_type>(1),
-              corgi::internals::ct_prod<size_type>);
-      }
-      return coeffs;
-  }
-
+#endif
 
-  /// Actual Morton Z-ordering from index list
-  // 
-  // what we compute: coeff . indices
-  //
-  // i.e., inner product of accumulated coefficients vector and index vector
-  constexpr index_type 
-  _compute_index(
-      const ::std::array<index_type, D>& index_array) const noexcept
-  {
-    return corgi::internals::ct_inner_product(
-        compute_index_coeffs(_lengths), 0,
-        index_array, 0, D,
-        static_cast<index_type>(0),
-        corgi::internals::ct_plus<index_type>,
-        corgi::internals::ct_prod<index_type>);
+    return index_array;
   }
 
   public:
@@ -328,7 +424,7 @@ class Grid
   corgi::internals::are_integral<Indices...>::value, index_type > 
   id(Indices... indices) const
   {
-    return _compute_index( _validate_index_range(indices...) );
+    return _indexer.encode( _validate_index_range(indices...) );
   }
 
 
@@ -362,43 +458,21 @@ class Grid
       return id_impl(indices, Indices{} );
   }
   
-  /// Inverse Morton Z-code
-  //
-  // TODO: make N-dimensional
-  corgi::internals::tuple_of<1, index_type> id2index(
-      uint64_t cid, 
-      std::array<size_type,1> /*lengths*/)
+  /// Inverse of id(); tile ID into tile indices 
+  corgi::internals::tuple_of<D, index_type> id2index(uint64_t cid) const
   {
-    corgi::internals::tuple_of<1, index_type> indices = std::make_tuple(cid);
-
-    return indices;
-  }
-
-  corgi::internals::tuple_of<2, index_type> id2index(
-      uint64_t cid,
-      std::array<size_type,2> lengths)
-  {
-    corgi::internals::tuple_of<2, index_type> indices = std::make_tuple
-      (
-       cid % lengths[0],
-      (cid / lengths[0]) % (lengths[1] )
-       );
-
-    return indices;
+    return corgi::internals::into_tuple( _indexer.decode(cid) );
   }
 
-  corgi::internals::tuple_of<3, index_type> id2index(
+  /// Inverse of id() for a grid of arbitrary dimensions
+  corgi::internals::tuple_of<D, index_type> id2index(
       uint64_t cid,
-      std::array<size_type,3> lengths)
+      const std::array<size_type, D>& lengths) const
   {
-    corgi::internals::tuple_of<3, index_type> indices = std::make_tuple
-      (
-       cid % lengths[0],
-      (cid / lengths[0]) % (lengths[1] ),
-       cid /(lengths[0] * lengths[1] )
-       );
+    if(lengths == _lengths) return id2index(cid);
 
-    return indices;
+    return corgi::internals::into_tuple( 
+        ordering_type(lengths).decode(cid) );
   }
 
 
@@ -423,28 +497,28 @@ class Grid
 
 
   // return global grid limits
-  template<typename T = size_type>
+  template<typename T = float_type>
   corgi::internals::enable_if_t< (D>=1), T> 
   get_xmin() { return _mins[0]; }
 
-  template<typename T = size_type>
+  template<typename T = float_type>
   corgi::internals::enable_if_t< (D>=2), T> 
   get_ymin() { return _mins[1]; }
 
-  template<typename T = size_type>
+  template<typename T = float_type>
   corgi::internals::enable_if_t< (D>=3), T> 
   get_zmin() { return _mins[2]; }
 
 
-  template<typename T = size_type>
+  template<typename T = float_type>
   corgi::internals::enable_if_t< (D>=1), T> 
   get_xmax() { return _maxs[0]; }
 
-  template<typename T = size_type>
+  template<typename T = float_type>
   corgi::internals::enable_if_t< (D>=2), T> 
   get_ymax() { return _maxs[1]; }
 
-  template<typename T = size_type>
+  template<typename T = float_type>
   corgi::internals::enable_if_t< (D>=3), T> 
   get_zmax() { return _maxs[2]; }
 
@@ -465,6 +539,40 @@ class Grid
     _maxs = maxs;
   }
 
+  /// Indices of the tile containing physical point x; coordinates
+  // outside the grid limits are wrapped periodically.
+  corgi::internals::tuple_of<D, size_t> tile_index_at(
+      const ::std::array<float_type, D>& x) const
+  {
+    ::std::array<size_t, D> ind;
+    for(size_t i=0; i<D; i++) {
+      float_type s = (x[i] - _mins[i])/(_maxs[i] - _mins[i]);
+      s -= std::floor(s);
+
+      // guard against s*len rounding up to len
+      ind[i] = std::min( static_cast<size_t>(s*_lengths[i]), _lengths[i]-1 );
+    }
+    return corgi::internals::into_tuple(ind);
+  }
+
+  /// ID of the tile containing physical point x
+  uint64_t tile_id_at(const ::std::array<float_type, D>& x) const
+  {
+    return id( tile_index_at(x) );
+  }
+
+  /// Rank owning the tile that contains physical point x
+  //
+  // NOTE: needs the full _mpi_grid; see allgather_mpi_grid.
+  int owner_at(const ::std::array<float_type, D>& x) const
+  {
+    assert(!_owners_partial);
+    return _mpi_grid( tile_index_at(x) );
+  }
+
+  /// is _mpi_grid only exact around my tiles
+  bool owners_partial() const { return _owners_partial; }
+
 
 
   public:
@@ -490,9 +598,6 @@ class Grid
     // calculate unique global tile ID
     uint64_t cid = id( indices );
 
-    // Erase any existing tiles to avoid emplace of doing nothing TODO: is this correct?
-    tiles.erase(cid);
-
     tileptr->index               = indices;
     tileptr->cid                 = cid;
     tileptr->communication.cid   = cid;
@@ -504,12 +609,13 @@ class Grid
     auto tmp = corgi::internals::into_array(indices);
     for(size_t i=0; i<D; i++) tileptr->communication.indices[i] = tmp[i];
 
-    // tiles.emplace(cid, std::move(tileptr)); // unique_ptr needs to be moved
-    tiles.emplace(cid, tileptr); // NOTE using c++14 emplace to avoid copying
-    //tiles.insert( std::make_pair(cid, tileptr) ); // NOTE using c++14 emplace to avoid copying
+    // replace any existing tile; slot (handle) of the tile is kept
+    tiles.insert_or_assign(cid, tileptr);
+    _nhoods_dirty = true;
       
     // add to my internal listing
-    _mpi_grid( indices ) = comm.rank();
+    _set_owner( indices, comm.rank() );
+    _classify_tile(cid);
   }
 
 
@@ -538,8 +644,8 @@ class Grid
     tileptr->cid     = cid;
     tileptr->lengths = _lengths;
 
-    tiles.erase(cid);
-    tiles.emplace(cid, tileptr); 
+    tiles.insert_or_assign(cid, tileptr);
+    _nhoods_dirty = true;
 
     update_tile(cm);
   }
@@ -550,8 +656,8 @@ class Grid
   // FIXME
   void create_tile(Communication& cm)
   {
-    //m_author = std::make_shared<Author>(t_author);
-    auto tileptr = std::make_shared<Tile_t>();
+    Tileptr tileptr = _tile_factory ? _tile_factory(*this, cm) : make_tile<Tile_t>();
+    assert(tileptr);
     tileptr->load_metainfo(cm);
 
     // additional grid info
@@ -560,8 +666,9 @@ class Grid
     // local
 
     // add
-    tiles.emplace(cm.cid, tileptr); // NOTE using c++14 emplace to avoid copying
-    _mpi_grid( tileptr->index ) = cm.owner;
+    tiles.insert(cm.cid, tileptr);
+    _set_owner( tileptr->index, cm.owner );
+    _classify_tile(cm.cid);
   }
 
   /// Update tile metadata
@@ -569,8 +676,11 @@ class Grid
   void update_tile(Communication& cm)
   {
     auto& tile = get_tile(cm.cid);
+    if(tile.communication.owner != cm.owner) _schedule_dirty = true;
+
     tile.load_metainfo(cm);
-    _mpi_grid( tile.index ) = cm.owner;
+    _set_owner( tile.index, cm.owner );
+    _classify_tile(cm.cid);
   }
 
 
@@ -604,10 +714,10 @@ class Grid
    * away from the Class.
    */
   Tile_t& get_tile(const uint64_t cid) {
-    auto it = tiles.find(cid);
-    if (it == tiles.end()) { throw std::invalid_argument("tile entry not found"); }
+    Tile_t* ptr = tiles.get(cid);
+    if (ptr == nullptr) { throw std::invalid_argument("tile entry not found"); }
 
-    return *(it->second);
+    return *ptr;
   }
 
   template<typename... Indices>
@@ -626,6 +736,18 @@ class Grid
     return it->second;
   }
 
+  /// \brief Get individual tile as a non-owning raw pointer; nullptr if not found
+  //
+  // Avoids the reference counting of get_tileptr() so this should be preferred 
+  // in inner loops (e.g., halo updates).
+  Tile_t* get_tile_rawptr(const uint64_t cid) const {
+    return tiles.get(cid);
+  }
+
+  Tile_t* get_tile_rawptr(const corgi::internals::tuple_of<D, size_t>& indices) const {
+    return tiles.get( id(indices) );
+  }
+
   template<typename... Indices>
     corgi::internals::enable_if_t< (sizeof...(Indices) == D) && 
     corgi::internals::are_integral<Indices...>::value, 
@@ -655,63 +777,103 @@ class Grid
   }
 
 
-  /// Return all local tiles
-  std::vector<uint64_t> get_local_tiles(
-      const bool sorted=false ) {
+  private:
 
-    std::vector<uint64_t> tile_list = get_tile_ids(sorted);
-    std::vector<uint64_t> ret;
-    ret.reserve(tile_list.size());
+  // --------------------------------------------------
+  // Tile classification
+  //
+  // Sorted lists of tile ids of each type are kept up to date
+  // whenever tile ownership changes. Listing tiles is then free.
 
-    for(auto elem : tile_list) {
-      if(tiles.at( elem )->communication.owner == comm.rank() ) {
-        ret.push_back(elem);
-      }
-    }
-    return ret;
+  /// my own tiles
+  std::vector<uint64_t> _local_tiles;
+
+  /// tiles owned by others
+  std::vector<uint64_t> _virtual_tiles;
+
+  /// my own tiles that have virtual neighbors
+  std::vector<uint64_t> _boundary_tiles;
+
+  /// insert into sorted list (if not there already)
+  static void _insert_sorted(std::vector<uint64_t>& list, uint64_t cid)
+  {
+    auto it = std::lower_bound(list.begin(), list.end(), cid);
+    if(it == list.end() || *it != cid) list.insert(it, cid);
+  }
+
+  /// is cid in the sorted list
+  static bool _in_sorted(const std::vector<uint64_t>& list, uint64_t cid)
+  {
+    return std::binary_search(list.begin(), list.end(), cid);
   }
 
+  /// remove from sorted list (if there)
+  static void _erase_sorted(std::vector<uint64_t>& list, uint64_t cid)
+  {
+    auto it = std::lower_bound(list.begin(), list.end(), cid);
+    if(it != list.end() && *it == cid) list.erase(it);
+  }
 
-  /// Return all tiles that are of VIRTUAL type.
-  std::vector<uint64_t> get_virtuals(
-      const bool sorted=false ) 
+  /// drop tile from all the classification lists
+  void _unclassify_tile(uint64_t cid)
   {
+    _nhoods_dirty = true;
+    _schedule_dirty = true;
+    _erase_sorted(_local_tiles,    cid);
+    _erase_sorted(_virtual_tiles,  cid);
+    _erase_sorted(_boundary_tiles, cid);
+  }
 
-    std::vector<uint64_t> tile_list = get_tile_ids(sorted);
-    std::vector<uint64_t> ret;
-    ret.reserve(tile_list.size());
+  /// (re)place tile into correct classification lists based on its owner
+  //
+  // Cached tables are only invalidated if the classification changes.
+  void _classify_tile(uint64_t cid)
+  {
+    auto& tile = get_tile(cid);
+    bool local = tile.communication.owner == comm.rank();
 
-    for(auto elem : tile_list) {
-      if(tiles.at( elem )->communication.owner != comm.rank() ) {
-        ret.push_back(elem);
-      }
+    // no virtual nbors and tile is mine -> opposite means its boundary
+    bool boundary = local && (tile.communication.number_of_virtual_neighbors != 0);
+
+    if( _in_sorted(_local_tiles,    cid) == local    &&
+        _in_sorted(_virtual_tiles,  cid) == !local   &&
+        _in_sorted(_boundary_tiles, cid) == boundary ) return;
+
+    _unclassify_tile(cid); // also invalidates neighborhoods
+
+    if(local) {
+      _insert_sorted(_local_tiles, cid);
+      if(boundary) _insert_sorted(_boundary_tiles, cid);
+    } else {
+      _insert_sorted(_virtual_tiles, cid);
     }
-    return ret;
   }
 
-  /// Return all local boundary tiles
-  // TODO: update this to use the internal boundary_tile_map
-  std::vector<uint64_t> get_boundary_tiles(
-      const bool sorted=false ) {
-
-    std::vector<uint64_t> tile_list = get_tile_ids(sorted);
-
-    size_t i = 0, len = tile_list.size();
-    while(i < len) {
-
-      // remove if there are no virtual nbors and tile is not mine -> opposite means its boundary
-      if (tiles.at( tile_list[i] )-> communication.number_of_virtual_neighbors == 0 || 
-          tiles.at( tile_list[i] )-> communication.owner != comm.rank()
-          ) {
-        std::swap(tile_list[i], tile_list.back());
-        tile_list.pop_back();
-        len -= 1;
-      } else {
-        i++;
-      }
-    }
 
-    return tile_list;
+  public:
+
+  /// Return all local tiles
+  //
+  // NOTE: list is always sorted; argument is kept for backwards compatibility.
+  const std::vector<uint64_t>& get_local_tiles(
+      const bool /*sorted*/=false ) const
+  {
+    return _local_tiles;
+  }
+
+
+  /// Return all tiles that are of VIRTUAL type.
+  const std::vector<uint64_t>& get_virtuals(
+      const bool /*sorted*/=false ) const
+  {
+    return _virtual_tiles;
+  }
+
+  /// Return all local boundary tiles
+  const std::vector<uint64_t>& get_boundary_tiles(
+      const bool /*sorted*/=false ) const
+  {
+    return _boundary_tiles;
   }
 
 
@@ -730,15 +892,89 @@ class Grid
     return local;
   }
 
+  // --------------------------------------------------
+  // cached neighborhoods
+
+  /// \brief Moore neighborhood of a tile
+  //
+  // Neighbors are in the order of corgi::ca::moore_stencil<D>().
+  struct Neighborhood {
+
+    /// number of neighbors
+    static constexpr size_t size = corgi::ca::moore_size<D>();
+
+    /// neighbor tile IDs
+    std::array<uint64_t, size> cids;
+
+    /// MPI rank owning the neighbor
+    std::array<int, size> owners;
+
+    /// neighbor tile; nullptr if it is not stored on this rank
+    std::array<Tile_t*, size> tiles;
+  };
+
+
+  private:
+
+  /// neighborhood tables indexed by tile handle
+  std::vector<Neighborhood> _nhoods;
+
+  /// are the tables out of date
+  bool _nhoods_dirty = true;
+
+  /// rebuild neighborhood tables of all stored tiles
+  void _build_nhoods()
+  {
+    _nhoods.resize(tiles.slots());
+
+    for(size_t h=0; h<tiles.slots(); h++) {
+      Tile_t* tile = tiles.slot(h);
+      if(tile == nullptr) continue;
+
+      auto& nh = _nhoods[h];
+      auto neigs = tile->nhood();
+      for(size_t n=0; n<Neighborhood::size; n++) {
+        uint64_t ncid = id(neigs[n]);
+        nh.cids[n]   = ncid;
+        nh.owners[n] = _mpi_grid(neigs[n]);
+        nh.tiles[n]  = tiles.get(ncid);
+      }
+    }
+
+    _nhoods_dirty = false;
+  }
+
+
+  public:
+
+  /*! \brief Get cached neighborhood of a stored tile
+   *
+   * Tables are rebuilt lazily after tiles have been added/removed or 
+   * tile ownership has changed. Call invalidate_neighborhoods() if
+   * `tiles` or the mpi grid is modified by hand.
+   */
+  const Neighborhood& get_neighborhood(uint64_t cid)
+  {
+    if(_nhoods_dirty) _build_nhoods();
+
+    auto h = tiles.handle(cid);
+    if(h == Tile_store::npos) { throw std::invalid_argument("tile entry not found"); }
+
+    return _nhoods[h];
+  }
+
+  /// force rebuild of the neighborhood tables on next use
+  void invalidate_neighborhoods() { _nhoods_dirty = true; }
+
+
   /// return all virtual tiles around the given tile
   std::vector<uint64_t> virtual_nhood(uint64_t cid) 
   {
-    auto& c = get_tile(cid);
-    auto neigs = c.nhood();
+    auto& nh = get_neighborhood(cid);
 
     std::vector<uint64_t> vnhood;
-    for(auto& indx: neigs) {
-      if(_mpi_grid(indx) != comm.rank()) vnhood.push_back( id(indx) );
+    for(size_t n=0; n<Neighborhood::size; n++) {
+      if(nh.owners[n] != comm.rank()) vnhood.push_back( nh.cids[n] );
     }
 
     return vnhood;
@@ -747,13 +983,11 @@ class Grid
   /// return all owners of virtual tiles around the given tile
   std::vector<int> virtual_nhood_owners(uint64_t cid) 
   {
-    auto& c = get_tile(cid);
-    auto neigs = c.nhood();
+    auto& nh = get_neighborhood(cid);
 
     std::vector<int> virtual_owners;
-    for(auto& indx: neigs) {
-      int whoami = _mpi_grid(indx); // Get tile id from index notation
-      if(whoami != comm.rank()) virtual_owners.push_back( whoami );
+    for(size_t n=0; n<Neighborhood::size; n++) {
+      if(nh.owners[n] != comm.rank()) virtual_owners.push_back( nh.owners[n] );
     }
 
     return virtual_owners;
@@ -780,6 +1014,10 @@ class Grid
   //  * */
   void analyze_boundaries() {
 
+    // previous topology; cached exchange state is kept if nothing changed
+    auto old_virtual_tile_list  = std::move(virtual_tile_list);
+    auto old_boundary_tile_list = std::move(boundary_tile_list);
+
     virtual_tile_list.clear();
     boundary_tile_list.clear();
     send_queue.clear();
@@ -790,9 +1028,9 @@ class Grid
       auto& c = get_tile(cid);
 
       // analyze c's neighborhood
-      auto neigs = c.nhood();
-      for(auto& indx: neigs) {
-        int whoami = _mpi_grid(indx); // Get tile id from index notation
+      auto& nh = get_neighborhood(cid);
+      for(size_t n=0; n<Neighborhood::size; n++) {
+        int whoami = nh.owners[n];
 
         // if nbor tile is virtual
         if(whoami != comm.rank()) {
@@ -801,8 +1039,7 @@ class Grid
           boundary_tile_list[cid].insert(whoami);
 
           // and then ncid is my virtual exterior tile
-          uint64_t ncid = id(indx);
-          virtual_tile_list[whoami].insert(ncid);
+          virtual_tile_list[whoami].insert(nh.cids[n]);
         }
       }
 
@@ -834,6 +1071,20 @@ class Grid
       }
     }
 
+    // boundary_tile_list is ordered so the new boundary listing is readily sorted
+    _boundary_tiles.clear();
+    _boundary_tiles.reserve(boundary_tile_list.size());
+    for(auto&& elem : boundary_tile_list) _boundary_tiles.push_back(elem.first);
+
+    bool changed = (virtual_tile_list  != old_virtual_tile_list) || 
+                   (boundary_tile_list != old_boundary_tile_list);
+    if(changed) _schedule_dirty = true;
+
+    // graph and windows are only invalidated once all ranks agree on it; 
+    // see _sync_topology
+    _topology_changed = _topology_changed || changed;
+    _topology_pending = true;
+
     //TODO: can also pre-create virtual tiles (if not existing in grid yet)  
 
   }
@@ -937,135 +1188,525 @@ class Grid
   std::vector<mpi::request> sent_adoption_messages;
   std::vector<mpi::request> recv_adoption_messages;
 
-  // /// Broadcast master ranks mpi_grid to everybody
-  void bcast_mpi_grid() {
-
-    // total size
-    int N = 1;
-    for (size_t i = 0; i<D; i++) N *= _lengths[i];
-    std::vector<int> tmp;
+  /*! How send_data/recv_data exchange tile data; see exchangeType. 
+   *
+   * With exchangeType::AGGREGATED all tiles bound for (or coming from) 
+   * the same rank travel in one message per mode; tiles then need to 
+   * implement pack_data/unpack_data instead of send_data/recv_data.
+   * exchangeType::HALO is the same but only the halo regions next to 
+   * the receiver's tiles are sent (Tile::pack_halo/unpack_halo).
+   */
+  int data_exchange = exchangeType::PER_TILE;
 
-    if (comm.rank() == 0) {
-      tmp = _mpi_grid.serialize();
-    } else {
-      tmp.resize(N);
-      for(int k=0; k<N; k++) {tmp[k] = -1;};
-    }
+  /*! How aggregated/halo messages travel; see transportType. 
+   *
+   * transportType::NEIGHBOR_COLLECTIVE runs every mode as one 
+   * MPI_Ineighbor_alltoallv on a graph communicator built from the 
+   * topology of the last analyze_boundaries. It is collective, so all 
+   * ranks must use the same transport. transportType::ONE_SIDED puts 
+   * the data directly into windows over the virtual tile buffers of the 
+   * receivers; windows are built once per mode and topology.
+   */
+  int data_transport = transportType::POINT_TO_POINT;
 
-    MPI_Bcast(&tmp[0],
-        N, 
-        MPI_INT, 
-        0, 
-        MPI_COMM_WORLD
-        );
+  /*! Exchange aggregated/halo data of ranks on the same node through 
+   * shared memory.
+   *
+   * Owners pack into their MPI_Win_allocate_shared segment and the 
+   * same-node receivers unpack straight from it; no message is sent. 
+   * Only the cross-node ranks go through data_transport. Needs fixed-size
+   * tile payloads and, like the transports, has to be the same on all ranks.
+   */
+  bool shared_memory = false;
 
-    // unpack
-    if(comm.rank() != 0) {
-      _mpi_grid.deserialize(tmp, _lengths);
-    }
-  }
+  /// outgoing data exchange; destination rank -> boundary tiles in cid order
+  std::map<int, std::vector<uint64_t>> send_schedule;
 
-  /// update work arrays from other nodes and send mine
-  void allgather_work_grid() 
-  {
+  /// incoming data exchange; origin rank -> virtual tiles in cid order
+  std::map<int, std::vector<uint64_t>> recv_schedule;
 
-    // total size
-    int N = 1;
-    for (size_t i = 0; i<D; i++) N *= _lengths[i];
+  /// outgoing tile metainfo packed per destination rank
+  std::map<int, std::vector<Communication>> send_tile_buffers;
 
-    // message buffers
-    std::vector<double> recv(N*comm.size());
-    std::vector<double> orig = _work_grid.serialize();
-
-    // mask all work values that are not mine
-    std::vector<int> ranks   = _mpi_grid.serialize();
-    for(size_t i=0; i<ranks.size(); i++) {
-      if( ranks[i] != comm.rank() ) orig[i] = -1.0;
-    }
-
-    MPI_Allgather(
-        &orig[0],
-        orig.size(), 
-        MPI_DOUBLE, 
-        &recv[0], 
-        orig.size(),
-        MPI_DOUBLE,
-        MPI_COMM_WORLD
-        );
-    
-  
-    std::vector<double> new_work(N);
-    std::fill(new_work.begin(), new_work.end(), -1.0);
+  /// compact encoding of send_tile_buffers
+  std::map<int, std::vector<char>> send_tile_bytes;
 
-    double val;
-    for(int j=0; j<comm.size(); j++) {
-      for(int i=0; i<N; i++) {
-        val = recv[j*N + i];
-        if(val != -1.0) {
-          assert(new_work[i] == -1.0); // test that we dont overwrite
-          new_work[i] = val;
-        }
-      }
-    }
-      
-    // test that we did not miss elements
-    for([[maybe_unused]] auto& val : new_work) assert(val != -1.0); 
+  /// compact encoding of adoptions
+  std::vector<char> adoption_bytes;
 
-    // upload back to grid
-    _work_grid.deserialize(new_work, _lengths);
+  /*! Encode tile metainfo and adoption messages compactly.
+   *
+   * Tile records carry only the delta-coded cid, owner and the fields that
+   * can not be derived on the receiving side; see _encode_metainfo. 
+   * If false, the fixed-size Communication datatype and adoption 
+   * arrays are sent instead.
+   *
+   * NOTE: has to be the same on all ranks.
+   */
+  bool compact_metainfo = true;
 
-  }
 
+  private:
 
-  // Update work load grid from my local tiles
-  void update_work()
+  /// field flags of compact metainfo records
+  enum metainfo_fields : unsigned char {
+    MI_TOP_OWNER = 1,
+    MI_COMMS     = 2,
+    MI_NVIRS     = 4,
+    MI_MINS      = 8,
+    MI_MAXS      = 16
+  };
+
+  /// default tile boundary derived from the grid limits
+  double _default_tile_lim(size_t ind, size_t d) const
   {
-    for(auto& cid : get_local_tiles()) {
-      auto& tile = get_tile(cid);
-     _work_grid( tile.index ) = tile.get_work();
-    }
+    return _mins[d] + (_maxs[d] - _mins[d])*static_cast<double>(ind)/static_cast<double>(_lengths[d]);
   }
 
+  /*! \brief Compact byte encoding of tile metainfo
+   *
+   * Format is
+   *   varint N, followed by N records of
+   *   svarint delta-cid | byte field mask | svarint owner | optional fields
+   *
+   * Indices are recovered from cid. Non-zero integer fields and tile 
+   * boundaries that differ from the grid-derived defaults are flagged 
+   * in the mask and appended.
+   */
+  void _encode_metainfo(
+      const std::vector<Communication>& cms, 
+      std::vector<char>& buf) const
+  {
+    buf.clear();
+    tools::byte_writer out(buf);
+
+    out.put_varint(cms.size());
+
+    uint64_t prev = 0;
+    for(auto& cm : cms) {
+      out.put_svarint( static_cast<int64_t>(cm.cid - prev) );
+      prev = cm.cid;
+
+      unsigned char mask = 0;
+      if(cm.top_virtual_owner != 0)           mask |= MI_TOP_OWNER;
+      if(cm.communications != 0)              mask |= MI_COMMS;
+      if(cm.number_of_virtual_neighbors != 0) mask |= MI_NVIRS;
+      for(size_t d=0; d<D; d++) {
+        auto ind = static_cast<size_t>(cm.indices[d]);
+        if(cm.mins[d] != _default_tile_lim(ind,   d)) mask |= MI_MINS;
+        if(cm.maxs[d] != _default_tile_lim(ind+1, d)) mask |= MI_MAXS;
+      }
 
+      out.put(mask);
+      out.put_svarint(cm.owner);
+      if(mask & MI_TOP_OWNER) out.put_svarint(cm.top_virtual_owner);
+      if(mask & MI_COMMS)     out.put_svarint(cm.communications);
+      if(mask & MI_NVIRS)     out.put_svarint(cm.number_of_virtual_neighbors);
+      if(mask & MI_MINS)      out.put(cm.mins.data(), D);
+      if(mask & MI_MAXS)      out.put(cm.maxs.data(), D);
+    }
+  }
 
-  /// Issue isends to everywhere
-  // First we send a warning message of how many tiles to expect.
-  // Based on this the receiving side can prepare accordingly.
-  void send_tiles() {
-
-    sent_info_messages.clear();
-    sent_tile_messages.clear();
+  /// Decode compact metainfo; records are appended to cms
+  void _decode_metainfo(
+      const char* ptr, 
+      size_t len,
+      std::vector<Communication>& cms) const
+  {
+    tools::byte_reader in(ptr, len);
 
-    // send all tiles
-    for(auto&& elem : boundary_tile_list) {
-      auto& tile = get_tile(elem.first);
+    auto n = static_cast<size_t>( in.get_varint() );
+    cms.reserve(cms.size() + n);
 
-      //std::cout << comm.rank() << " sending cid message " << elem.first << " ---> ";
-      for(int dest : elem.second) {
-        //std::cout << "," << comm.rank() << ":" << dest;
+    uint64_t prev = 0;
+    for(size_t i=0; i<n; i++) {
+      Communication cm{};
 
-        mpi::request req;
-        req = comm.isend(dest, commType::TILEDATA, tile.communication);
+      prev += static_cast<uint64_t>( in.get_svarint() );
+      cm.cid = prev;
 
-        sent_tile_messages.push_back( req );
+      auto ind = _indexer.decode(cm.cid);
+      for(size_t d=0; d<D; d++) {
+        cm.indices[d] = static_cast<int>(ind[d]);
+        cm.mins[d]    = _default_tile_lim(ind[d],   d);
+        cm.maxs[d]    = _default_tile_lim(ind[d]+1, d);
       }
 
-      //std::cout << "\n";
+      auto mask = in.get<unsigned char>();
+      cm.owner = static_cast<int>( in.get_svarint() );
+      if(mask & MI_TOP_OWNER) cm.top_virtual_owner           = static_cast<int>( in.get_svarint() );
+      if(mask & MI_COMMS)     cm.communications              = static_cast<int>( in.get_svarint() );
+      if(mask & MI_NVIRS)     cm.number_of_virtual_neighbors = static_cast<int>( in.get_svarint() );
+      if(mask & MI_MINS)      in.get(cm.mins.data(), D);
+      if(mask & MI_MAXS)      in.get(cm.maxs.data(), D);
+
+      cms.push_back(cm);
     }
   }
 
-  /// Send individual tile to dest
-  void send_tile(uint64_t cid, int dest)
+  /// Encode list of tile IDs (_no_cid entries are skipped) 
+  static void _encode_cids(
+      const std::vector<uint64_t>& cids, 
+      size_t maxn,
+      std::vector<char>& buf)
   {
-    mpi::request req;
+    std::vector<uint64_t> sorted;
+    for(size_t i=0; i<std::min(maxn, cids.size()); i++) {
+      if(cids[i] != _no_cid) sorted.push_back(cids[i]);
+    }
+    std::sort(sorted.begin(), sorted.end());
 
-    auto& tile = get_tile(cid);
-    //std::cout << comm.rank() << ": sending cid" << cid << "/" << tile.communication.cid << "\n";
-    req = comm.isend(dest, 0, tile.communication);
+    buf.clear();
+    tools::byte_writer out(buf);
+    out.put_varint(sorted.size());
 
-    // FIXME and make non-blocking
-    req.wait();
- }
+    uint64_t prev = 0;
+    for(uint64_t cid : sorted) {
+      out.put_svarint( static_cast<int64_t>(cid - prev) );
+      prev = cid;
+    }
+  }
+
+  /// Decode list of tile IDs into fixed-length array padded with _no_cid
+  static void _decode_cids(
+      const char* ptr, 
+      size_t len,
+      uint64_t* cids, 
+      size_t maxn)
+  {
+    tools::byte_reader in(ptr, len);
+    auto n = static_cast<size_t>( in.get_varint() );
+    assert(n <= maxn);
+
+    uint64_t prev = 0;
+    for(size_t i=0; i<maxn; i++) {
+      if(i < n) {
+        prev += static_cast<uint64_t>( in.get_svarint() );
+        cids[i] = prev;
+      } else {
+        cids[i] = _no_cid;
+      }
+    }
+  }
+
+  /// Receive one message of unknown length from each rank in origs
+  //
+  // Messages are handled in arrival order: every rank that is still
+  // expected is probed and on_recv(orig, bytes) called for those that
+  // have arrived; if none has, we block on the first pending rank.
+  // Only expected ranks are probed so a message of the next round is
+  // never matched here.
+  template<typename F>
+  void _recv_bytes(std::vector<int> pending, int tag, F&& on_recv)
+  {
+    std::vector<char> buf;
+    MPI_Message msg;
+    MPI_Status status;
+
+    auto unpack = [&](int orig) {
+      int count = 0;
+      MPI_Get_count(&status, MPI_BYTE, &count);
+
+      buf.resize( static_cast<size_t>(count) );
+      MPI_Mrecv(buf.data(), count, MPI_BYTE, &msg, MPI_STATUS_IGNORE);
+
+      on_recv(orig, buf);
+    };
+
+    while(!pending.empty()) {
+      size_t nleft = pending.size();
+
+      for(size_t k=0; k<pending.size(); ) {
+        int flag = 0;
+        MPI_Improbe(pending[k], tag, comm, &flag, &msg, &status);
+        if(!flag) { k++; continue; }
+
+        unpack(pending[k]);
+        pending.erase(pending.begin() + static_cast<std::ptrdiff_t>(k));
+      }
+
+      // nothing has arrived yet; wait for the first one
+      if(pending.size() == nleft) {
+        MPI_Mprobe(pending[0], tag, comm, &msg, &status);
+        unpack(pending[0]);
+        pending.erase(pending.begin());
+      }
+    }
+  }
+
+  /// create a new virtual tile or update existing one from metainfo
+  void _create_or_update_tile(Communication& rcom)
+  {
+    if(this->tiles.count(rcom.cid) == 0) { // Tile does not exist yet; create it
+      // TODO: Check validity of the tile better
+      create_tile(rcom);
+    } else { // Tile is already on my virtual list; update
+      update_tile(rcom);  
+    }
+  }
+
+  /// check that every tile is owned by exactly one rank
+  //
+  // NOTE: collective over all ranks; does nothing if NDEBUG is defined.
+  void _assert_single_owners(
+      [[maybe_unused]] const int* ranks, 
+      [[maybe_unused]] int N)
+  {
+#ifndef NDEBUG
+    std::vector<int> owners(N);
+    for(int i=0; i<N; i++) owners[i] = ranks[i] == comm.rank() ? 1 : 0;
+
+    MPI_Allreduce(MPI_IN_PLACE, owners.data(), N, MPI_INT, MPI_SUM, comm);
+    for(auto& n : owners) assert(n == 1); // nobody or several ranks own the tile
+#endif
+  }
+
+
+  public:
+
+  // /// Broadcast master ranks mpi_grid to everybody
+  //
+  // Contiguous storage is broadcasted in-place; otherwise grid is
+  // serialized into a temporary buffer first.
+  void bcast_mpi_grid() {
+
+    // total size
+    int N = 1;
+    for (size_t i = 0; i<D; i++) N *= _lengths[i];
+
+    if constexpr (storage_type<int>::is_contiguous) {
+      assert( static_cast<int>(_mpi_grid.size()) == N );
+
+      MPI_Bcast(_mpi_grid.data(),
+          N, 
+          MPI_INT, 
+          0, 
+          comm
+          );
+    } else {
+      std::vector<int> tmp;
+
+      if (comm.rank() == 0) {
+        tmp = _mpi_grid.serialize();
+      } else {
+        tmp.resize(N);
+        for(int k=0; k<N; k++) {tmp[k] = -1;};
+      }
+
+      MPI_Bcast(&tmp[0],
+          N, 
+          MPI_INT, 
+          0, 
+          comm
+          );
+
+      // unpack
+      if(comm.rank() != 0) {
+        _mpi_grid.deserialize(tmp, _lengths);
+      }
+    }
+
+    _nhoods_dirty = true;
+    _frontier_dirty = true;
+    _loads_dirty = true;
+    _owners_partial = false;
+  }
+
+  /// Rebuild the whole mpi_grid from the tiles that every rank owns
+  //
+  // Every rank keeps only the owner values of its own tiles and the grids 
+  // are then merged with a global max. This makes owner lookups valid 
+  // again after adoption_council_distributed.
+  void allgather_mpi_grid() 
+  {
+
+    // total size
+    int N = 1;
+    for (size_t i = 0; i<D; i++) N *= _lengths[i];
+
+    const int myrank = comm.rank();
+
+    if constexpr (storage_type<int>::is_contiguous) {
+      assert( static_cast<int>(_mpi_grid.size()) == N );
+
+      int* ranks = _mpi_grid.data();
+      for(int i=0; i<N; i++) {
+        if( ranks[i] != myrank ) ranks[i] = -1;
+      }
+
+      MPI_Allreduce(
+          MPI_IN_PLACE,
+          ranks,
+          N, 
+          MPI_INT, 
+          MPI_MAX,
+          comm
+          );
+    } else {
+      std::vector<int> ranks = _mpi_grid.serialize();
+      for(int i=0; i<N; i++) {
+        if( ranks[i] != myrank ) ranks[i] = -1;
+      }
+
+      MPI_Allreduce(
+          MPI_IN_PLACE,
+          ranks.data(),
+          N, 
+          MPI_INT, 
+          MPI_MAX,
+          comm
+          );
+
+      // upload back to grid
+      _mpi_grid.deserialize(ranks, _lengths);
+    }
+
+    _nhoods_dirty = true;
+    _frontier_dirty = true;
+    _loads_dirty = true;
+    _owners_partial = false;
+  }
+
+  /// update work arrays from other nodes and send mine
+  //
+  // Every rank zeroes the work values of tiles that it does not own 
+  // and the grids are then merged with a global sum. Memory stays O(N) 
+  // irrespective of the number of ranks.
+  void allgather_work_grid() 
+  {
+
+    // total size
+    int N = 1;
+    for (size_t i = 0; i<D; i++) N *= _lengths[i];
+
+    const int myrank = comm.rank();
+
+    if constexpr (storage_type<int>::is_contiguous && 
+                  storage_type<double>::is_contiguous) {
+      assert( static_cast<int>(_work_grid.size()) == N );
+      assert( static_cast<int>(_mpi_grid.size())  == N );
+
+      // mask all work values that are not mine
+      double*    work  = _work_grid.data();
+      const int* ranks = _mpi_grid.data();
+      _assert_single_owners(ranks, N);
+      for(int i=0; i<N; i++) {
+        if( ranks[i] != myrank ) work[i] = 0.0;
+      }
+
+      MPI_Allreduce(
+          MPI_IN_PLACE,
+          work,
+          N, 
+          MPI_DOUBLE, 
+          MPI_SUM,
+          comm
+          );
+    } else {
+      std::vector<double> work = _work_grid.serialize();
+
+      // mask all work values that are not mine
+      std::vector<int> ranks   = _mpi_grid.serialize();
+      _assert_single_owners(ranks.data(), N);
+      for(int i=0; i<N; i++) {
+        if( ranks[i] != myrank ) work[i] = 0.0;
+      }
+
+      MPI_Allreduce(
+          MPI_IN_PLACE,
+          work.data(),
+          N, 
+          MPI_DOUBLE, 
+          MPI_SUM,
+          comm
+          );
+    
+      // upload back to grid
+      _work_grid.deserialize(work, _lengths);
+    }
+
+    _loads_dirty = true;
+
+    // others' loads can not be summed from a partial _mpi_grid
+    if(_owners_partial) {
+      _update_loads();
+      MPI_Allgather(MPI_IN_PLACE, 1, MPI_DOUBLE, _loads.data(), 1, MPI_DOUBLE, comm);
+    }
+  }
+
+
+  // Update work load grid from my local tiles
+  void update_work()
+  {
+    for(auto& cid : get_local_tiles()) {
+      auto& tile = get_tile(cid);
+     _work_grid( tile.index ) = tile.get_work();
+    }
+    _loads_dirty = true;
+  }
+
+
+
+  /// Issue isends to everywhere
+  // First we send a warning message of how many tiles to expect.
+  // Based on this the receiving side can prepare accordingly.
+  //
+  // Metainfo of all boundary tiles going to the same rank is packed 
+  // into one contiguous message (in cid order).
+  void send_tiles() {
+
+    sent_info_messages.clear();
+    sent_tile_messages.clear();
+    send_tile_buffers.clear();
+
+    // pack all tiles
+    for(auto&& elem : boundary_tile_list) {
+      auto& tile = get_tile(elem.first);
+      for(int dest : elem.second) {
+        send_tile_buffers[dest].push_back( tile.communication );
+      }
+    }
+
+    // one message per rank
+    send_tile_bytes.clear();
+    for(auto&& elem : send_tile_buffers) {
+      auto& buf = elem.second;
+
+      if(compact_metainfo) {
+        auto& bytes = send_tile_bytes[elem.first];
+        _encode_metainfo(buf, bytes);
+
+        sent_tile_messages.push_back( 
+            comm.isend(elem.first, 
+              commType::TILEDATA, 
+              bytes.data(), 
+              static_cast<int>(bytes.size()) ) 
+            );
+        continue;
+      }
+
+      mpi::request req;
+      req = comm.isend(elem.first, 
+          commType::TILEDATA, 
+          buf.data(), 
+          static_cast<int>(buf.size()) );
+
+      sent_tile_messages.push_back( req );
+    }
+  }
+
+  /// Send individual tile to dest
+  void send_tile(uint64_t cid, int dest)
+  {
+    mpi::request req;
+
+    auto& tile = get_tile(cid);
+    //std::cout << comm.rank() << ": sending cid" << cid << "/" << tile.communication.cid << "\n";
+    req = comm.isend(dest, 0, tile.communication);
+
+    // FIXME and make non-blocking
+    req.wait();
+ }
 
   void recv_tile(int orig)
   {
@@ -1094,6 +1735,11 @@ class Grid
  }
 
   /// Receive incoming stuff
+  //
+  // Every neighboring rank sends all of its tiles in one message; 
+  // these are received into consecutive segments of a presized buffer
+  // (so that the addresses stay fixed) and tiles are created/updated 
+  // rank by rank in the order in which the messages complete.
   std::vector<Communication> rcoms;
   void recv_tiles() {
     recv_tile_messages.clear();
@@ -1101,47 +1747,70 @@ class Grid
 
     size_t nelems = 0;
     for(auto&& elem : virtual_tile_list) nelems += elem.second.size();
-    rcoms.resize( nelems );
 
-    int i = 0;
-    for(auto&& elem : virtual_tile_list) {
-      int orig = elem.first;
+    // variable-length compact messages; unpacked in arrival order
+    if(compact_metainfo) {
+      rcoms.reserve( nelems );
 
-      //std::cout << comm.rank() << " receiving from "<<  elem.first << " <--- ";
-      for(uint64_t cid : elem.second) {
-        (void)cid; // hack to suppress unused variable warning
-
-        mpi::request reqc;
-
-        //rcoms.emplace_back();
-        //std::cout << "," << comm.rank() << ":" << cid << "(" << rcoms.size()<<")" ;
-        reqc = comm.irecv(orig, commType::TILEDATA, rcoms.at(i) );
-        reqc.wait(); // FIXME: have to wait because emplace_back might trigger a re-allocation;
-                     // this leads to different memory location and incorrect pointer 
-                     // for the incoming message. Can be maybe solved by reserving the
-                     // vector beforehand
-        
-        recv_tile_messages.push_back( reqc );
-        i++;
-      }
+      std::vector<int> origs;
+      for(auto&& elem : virtual_tile_list) origs.push_back(elem.first);
+
+      _recv_bytes(origs, commType::TILEDATA, 
+          [&]([[maybe_unused]] int orig, const std::vector<char>& bytes) {
+            size_t first = rcoms.size();
+            _decode_metainfo(bytes.data(), bytes.size(), rcoms);
+            assert(rcoms.size() - first == virtual_tile_list[orig].size());
 
-      //std::cout << "\n";
+            for(size_t i=first; i<rcoms.size(); i++) _create_or_update_tile(rcoms[i]);
+          });
+
+      mpi::wait_all(sent_tile_messages.begin(), sent_tile_messages.end());
+      return;
     }
 
-    //std::cout << comm.rank() << " waiting...\n";
+    rcoms.resize( nelems );
 
-    // process all mpi requests; otherwise we leak memory
-    mpi::wait_all(recv_tile_messages.begin(), recv_tile_messages.end());
-    //std::cout << comm.rank() << " unpacking...\n";
+    // one message per rank; segment [offsets[r], offsets[r+1]) of rcoms
+    size_t nmsgs = virtual_tile_list.size();
+    std::vector<MPI_Request> reqs(nmsgs, MPI_REQUEST_NULL);
+    std::vector<size_t> offsets(nmsgs+1, 0);
+
+    if(nelems > 0) {
+      MPI_Datatype cm_type = mpi::get_mpi_datatype<Communication>(rcoms[0]);
+
+      size_t r = 0;
+      for(auto&& elem : virtual_tile_list) {
+        int orig = elem.first;
+        offsets[r+1] = offsets[r] + elem.second.size();
+
+        MPI_Irecv(&rcoms[offsets[r]], 
+            static_cast<int>(elem.second.size()), 
+            cm_type, 
+            orig, 
+            commType::TILEDATA, 
+            comm, 
+            &reqs[r]);
+        r++;
+      }
+    }
 
-    // unpack here
-    for(auto rcom : rcoms) {
-      if(this->tiles.count(rcom.cid) == 0) { // Tile does not exist yet; create it
-        // TODO: Check validity of the tile better
-        create_tile(rcom);
-      } else { // Tile is already on my virtual list; update
-        update_tile(rcom);  
+    // unpack tiles as their messages arrive
+    std::vector<int> completed(nmsgs);
+    size_t nleft = nelems > 0 ? nmsgs : 0;
+    while(nleft > 0) {
+      int ndone = 0;
+      MPI_Waitsome(static_cast<int>(nmsgs), 
+          reqs.data(), 
+          &ndone, 
+          completed.data(), 
+          MPI_STATUSES_IGNORE);
+
+      for(int k=0; k<ndone; k++) {
+        size_t r = static_cast<size_t>(completed[k]);
+
+        for(size_t i=offsets[r]; i<offsets[r+1]; i++) _create_or_update_tile(rcoms[i]);
       }
+      nleft -= static_cast<size_t>(ndone);
     }
 
     //std::cout << comm.rank() << " waiting sents...\n";
@@ -1159,112 +1828,332 @@ class Grid
   // conclusion.
   
   private:
-  std::vector<int> adoptions; 
-  std::vector<int> kidnaps; 
+  std::vector<uint64_t> adoptions; 
+  std::vector<uint64_t> kidnaps; 
+
+  /// padding entry of the fixed-length adoption messages
+  static constexpr uint64_t _no_cid = std::numeric_limits<uint64_t>::max();
   double min_quota =  0.05;
   double max_quota =  0.05; // in fraction of all tiles per color
 
-
-
-  public:
-  /// Compute maximum number of new tiles I can adopt
-  double get_quota(int rank)
+  // --------------------------------------------------
+  // Ownership frontier
+  //
+  // A tile can only change color if one of its Moore neighbors already 
+  // has the new color (see the velocity check in adoption_council2), so 
+  // the council only needs to look at tiles that have a differently 
+  // colored Moore neighbor. The set is kept as a sorted list of flat 
+  // (column-major) grid positions and patched locally whenever the 
+  // council moves a tile; any other change to _mpi_grid triggers a full 
+  // rebuild on next use.
+
+  /// tiles with at least one differently colored Moore neighbor
+  std::vector<uint64_t> _frontier;
+
+  /// is the frontier out of date
+  bool _frontier_dirty = true;
+
+  /// flat position of a tile in the global grid
+  size_t _flat_position(const corgi::internals::tuple_of<D, size_t>& indices) const
   {
-    // integrate over all work
-    int N = 1;
-    for (size_t i = 0; i<D; i++) N *= _lengths[i];
-    
-    // ideal work balance
-    double ideal_work = 0.0;
-    for(auto& elem : _work_grid) ideal_work += elem.second;
-    ideal_work /= comm.size();
+    auto ind = corgi::internals::into_array(indices);
 
-    // current work load
-    double current_workload = 0.0;
-    for(auto& elem : _mpi_grid) {
-      if(elem.second == rank) {
-        current_workload += _work_grid( elem.first );
-      }
+    size_t pos = 0, stride = 1;
+    for(size_t i=0; i<D; i++) {
+      pos    += ind[i]*stride;
+      stride *= _lengths[i];
     }
+    return pos;
+  }
 
-    /// excess work I can do
-    double excess = ideal_work - current_workload;
-    //excess = excess > 0.0 ? excess : 0.0;
-
-
-    //if(rank == comm.rank()) {
-    //std::cout << comm.rank() << " get_quota for rank gives "
-    //  << "ideal_work:" << ideal_work
-    //  << "current   :" << current_workload
-    //  << "excess   :" << excess
-    //  << "\n";
-    //}
+  /// inverse of _flat_position
+  corgi::internals::tuple_of<D, size_t> _flat_index(size_t pos) const
+  {
+    std::array<size_t, D> ind;
+    for(size_t i=0; i<D; i++) {
+      ind[i] = pos % _lengths[i];
+      pos   /= _lengths[i];
+    }
+    return corgi::internals::into_tuple(ind);
+  }
 
-    return excess;
+  /// does the tile have a differently colored Moore neighbor
+  bool _on_frontier(const corgi::internals::tuple_of<D, size_t>& ind)
+  {
+    static constexpr auto moore = corgi::ca::moore_stencil<D>();
 
-    double quota = excess > max_quota*ideal_work ? max_quota*ideal_work : excess;
-    return quota > -min_quota*ideal_work ? quota : -min_quota*ideal_work;
+    int color = _mpi_grid(ind);
+    for(auto& reli : moore) {
+      if(_mpi_grid( neighs(ind, reli) ) != color) return true;
+    }
+    return false;
   }
-  
-  /// Propagate CA rules one step forward and decide who adopts who
-  void adoption_council()
+
+  /// re-evaluate frontier membership of a single tile
+  void _refresh_frontier(const corgi::internals::tuple_of<D, size_t>& ind)
   {
-    int quota = (int)get_quota(comm.rank());
+    uint64_t pos = _flat_position(ind);
+    if(_on_frontier(ind)) { 
+      _insert_sorted(_frontier, pos);
+    } else {
+      _erase_sorted(_frontier, pos);
+    }
+  }
 
-    // collect virtual tiles and their metainfo into a container
-    std::vector<Communication> virtuals;
-    for(auto cid : get_virtuals() ) {
-      auto& tile = get_tile(cid);
-      virtuals.push_back(tile.communication);
+  /// sweep the whole grid for frontier tiles
+  void _build_frontier()
+  {
+    _frontier.clear();
+    for(auto&& elem : _mpi_grid) {
+      if(_on_frontier(elem.first)) _frontier.push_back( _flat_position(elem.first) );
     }
 
-    // sort in descending order using lambda function
-    std::sort(virtuals.begin(), virtuals.end(), 
-        [](const auto& lhs, const auto& rhs) 
-    {
-      return lhs.number_of_virtual_neighbors > rhs.number_of_virtual_neighbors;
-    });
+    // sparse_grid iterates in lexicographic order
+    std::sort(_frontier.begin(), _frontier.end());
+    _frontier_dirty = false;
+  }
 
+  /// \brief Tabulated Gaussian kernel of the council
+  //
+  // Weights only depend on the offset and are computed once. Periodic 
+  // wrapping is resolved with per-dimension lookup tables that directly 
+  // give the flat contribution of a (possibly out-of-range) coordinate,
+  // so locating a kernel cell takes D table reads.
+  struct Council_kernel {
 
-    // now loop over all virtual tiles and check if I can adopt someone
-    adoptions.clear();
-    for(auto& vir : virtuals) {
+    /// kernel radius; negative if not built yet
+    int radius = -1;
 
-      //if(vir.number_of_virtual_neighbors <= 3) continue;
+    /// weight of the tile itself
+    double norm = 0.0;
 
-      // skip tiles where I am not the top owner
-      if(vir.top_virtual_owner == comm.rank()) {
-        adoptions.push_back( vir.cid );
+    /// relative offsets (D ints per kernel cell) and their weights
+    std::vector<int>    offsets;
+    std::vector<double> weights;
 
-        //std::cout << comm.rank() 
-        //  << ": adoption council marks " << vir.cid
-        //  << " at " << vir.indices[0] << " " << vir.indices[1] << "\n";
-      }
+    /// wrapped[d][n + radius] = stride_d*(n mod L_d) for n in [-radius, L_d + radius)
+    std::array<std::vector<size_t>, D> wrapped;
 
-      if( (int)adoptions.size() >= quota) break;
+    /// flat position of kernel cell k around tile ind
+    size_t position(const std::array<size_t, D>& ind, size_t k) const
+    {
+      size_t pos = 0;
+      for(size_t i=0; i<D; i++) {
+        pos += wrapped[i][ static_cast<size_t>( static_cast<int>(ind[i]) + offsets[k*D + i] + radius ) ];
+      }
+      return pos;
     }
+  };
 
-  }
+  Council_kernel _kernel;
 
-  /// general N-dim implementation of wrap
-  size_t wrap(int ind, size_t d)
+  /// build the kernel tables on first use; grid lengths never change
+  const Council_kernel& _council_kernel()
   {
-    auto N = static_cast<int>(_lengths[d]);
-    while (ind < 0) { ind += N; }
-    while (ind >= N) { ind -= N; }
-    return static_cast<size_t>(ind);
-  }
+    if(_kernel.radius >= 0) return _kernel;
 
+    // radius of Gaussian kernel
+    int Ng = sqrt(*std::max_element(_lengths.begin(), _lengths.end() )); 
+    auto Rg = static_cast<double>(Ng);
 
-  /// return index of tiles in relative to my position
-  corgi::internals::tuple_of<D, size_t> neighs(
-      corgi::internals::tuple_of<D, int> indices,
-      corgi::internals::tuple_of<D, int> indices_rel)
-  {
-    auto cur = corgi::internals::into_array(indices);
-    auto rel = corgi::internals::into_array(indices_rel);
+    // normalization of multidimensional univariate normal distribution
+    _kernel.radius = Ng;
+    _kernel.norm   = 1.0/sqrt(std::pow(2.0*M_PI, D)*Rg*Rg);
 
-    for(size_t i=0; i<D; i++) {
+    // gaussian kernel; i.e., relative indices how we convolve
+    for(auto& reli : corgi::ca::chessboard_neighborhood<D>(Ng)) {
+      auto r   = static_cast<double>( geom::manhattan_distance<D>(reli) );  
+      auto rel = corgi::internals::into_array(reli);
+
+      _kernel.offsets.insert(_kernel.offsets.end(), rel.begin(), rel.end());
+      _kernel.weights.push_back( _kernel.norm*exp(-0.5*r*r/Rg/Rg) );
+    }
+
+    size_t stride = 1;
+    for(size_t i=0; i<D; i++) {
+      auto L = static_cast<int>(_lengths[i]);
+
+      auto& table = _kernel.wrapped[i];
+      table.resize(L + 2*Ng);
+      for(int n=-Ng; n<L+Ng; n++) table[n+Ng] = stride*static_cast<size_t>( (n % L + L) % L );
+
+      stride *= _lengths[i];
+    }
+
+    return _kernel;
+  }
+
+  /// global ownership grid as a flat (column-major) array
+  const int* _owner_array(std::vector<int>& scratch)
+  {
+    if constexpr (storage_type<int>::is_contiguous) {
+      return _mpi_grid.data();
+    } else {
+      scratch = _mpi_grid.serialize();
+      return scratch.data();
+    }
+  }
+
+  // --------------------------------------------------
+  // Load accounting
+  //
+  // Work owned by each rank and the total work are summed in one pass 
+  // over the grids after the work grid has changed; ownership changes 
+  // just move the work of the tile between the two ranks.
+
+  /// total work of each rank
+  std::vector<double> _loads;
+
+  /// sum of all work
+  double _total_work = 0.0;
+
+  /// are the loads out of date
+  bool _loads_dirty = true;
+
+  /// is _mpi_grid only exact around my tiles (see adoption_council_distributed)
+  bool _owners_partial = false;
+
+  /// sum work of every rank in a single sweep
+  //
+  // With a partial _mpi_grid only my own load is summed; the others 
+  // keep their previous values (allgather_work_grid refreshes them).
+  void _update_loads()
+  {
+    _loads.resize(comm.size(), 0.0);
+    if(!_owners_partial) std::fill(_loads.begin(), _loads.end(), 0.0);
+    _loads[comm.rank()] = 0.0;
+    _total_work = 0.0;
+
+    for(auto&& elem : _mpi_grid) {
+      double work = _work_grid(elem.first);
+      _total_work += work;
+
+      int rank = elem.second;
+      if(_owners_partial && rank != comm.rank()) continue;
+      if(0 <= rank && rank < comm.size()) _loads[rank] += work;
+    }
+
+    _loads_dirty = false;
+  }
+
+  /// move work of the tile from one rank to another
+  void _move_load(const corgi::internals::tuple_of<D, size_t>& ind, int from, int to)
+  {
+    if(_loads_dirty) return;
+
+    if(0 <= from && from < comm.size() && 0 <= to && to < comm.size()) {
+      double work = _work_grid(ind);
+      _loads[from] -= work;
+      _loads[to]   += work;
+    } else {
+      _loads_dirty = true;
+    }
+  }
+
+  /// write owner of a tile into the global grid
+  void _set_owner(const corgi::internals::tuple_of<D, size_t>& ind, int owner)
+  {
+    int& color = _mpi_grid(ind);
+    if(color == owner) return;
+
+    _move_load(ind, color, owner);
+    color = owner;
+    _frontier_dirty = true;
+    _nhoods_dirty   = true;
+  }
+
+
+
+  public:
+  /// Compute maximum number of new tiles I can adopt
+  double get_quota(int rank)
+  {
+    if(_loads_dirty) _update_loads();
+
+    // ideal work balance
+    double ideal_work = _total_work/comm.size();
+
+    // current work load
+    double current_workload = _loads[rank];
+
+    /// excess work I can do
+    double excess = ideal_work - current_workload;
+    //excess = excess > 0.0 ? excess : 0.0;
+
+
+    //if(rank == comm.rank()) {
+    //std::cout << comm.rank() << " get_quota for rank gives "
+    //  << "ideal_work:" << ideal_work
+    //  << "current   :" << current_workload
+    //  << "excess   :" << excess
+    //  << "\n";
+    //}
+
+    return excess;
+
+    double quota = excess > max_quota*ideal_work ? max_quota*ideal_work : excess;
+    return quota > -min_quota*ideal_work ? quota : -min_quota*ideal_work;
+  }
+  
+  /// Propagate CA rules one step forward and decide who adopts who
+  void adoption_council()
+  {
+    int quota = (int)get_quota(comm.rank());
+
+    // collect virtual tiles and their metainfo into a container
+    std::vector<Communication> virtuals;
+    for(auto cid : get_virtuals() ) {
+      auto& tile = get_tile(cid);
+      virtuals.push_back(tile.communication);
+    }
+
+    // sort in descending order using lambda function
+    std::sort(virtuals.begin(), virtuals.end(), 
+        [](const auto& lhs, const auto& rhs) 
+    {
+      return lhs.number_of_virtual_neighbors > rhs.number_of_virtual_neighbors;
+    });
+
+
+    // now loop over all virtual tiles and check if I can adopt someone
+    adoptions.clear();
+    for(auto& vir : virtuals) {
+
+      //if(vir.number_of_virtual_neighbors <= 3) continue;
+
+      // skip tiles where I am not the top owner
+      if(vir.top_virtual_owner == comm.rank()) {
+        adoptions.push_back( vir.cid );
+
+        //std::cout << comm.rank() 
+        //  << ": adoption council marks " << vir.cid
+        //  << " at " << vir.indices[0] << " " << vir.indices[1] << "\n";
+      }
+
+      if( (int)adoptions.size() >= quota) break;
+    }
+
+  }
+
+  /// general N-dim implementation of wrap
+  size_t wrap(int ind, size_t d)
+  {
+    auto N = static_cast<int>(_lengths[d]);
+    while (ind < 0) { ind += N; }
+    while (ind >= N) { ind -= N; }
+    return static_cast<size_t>(ind);
+  }
+
+
+  /// return index of tiles in relative to my position
+  corgi::internals::tuple_of<D, size_t> neighs(
+      corgi::internals::tuple_of<D, int> indices,
+      corgi::internals::tuple_of<D, int> indices_rel)
+  {
+    auto cur = corgi::internals::into_array(indices);
+    auto rel = corgi::internals::into_array(indices_rel);
+
+    for(size_t i=0; i<D; i++) {
       cur[i] = static_cast<size_t>(
           wrap( static_cast<int>(rel[i]) + 
             static_cast<int>(cur[i]), i)
@@ -1275,40 +2164,64 @@ class Grid
     return ret;
   }
 
+  /// index of tile at relative offset (e.g., from corgi::ca stencils)
+  corgi::internals::tuple_of<D, size_t> neighs(
+      const corgi::internals::tuple_of<D, size_t>& indices,
+      const corgi::ca::offset_t<D>& rel)
+  {
+    auto cur = corgi::internals::into_array(indices);
+    for(size_t i=0; i<D; i++) {
+      cur[i] = static_cast<size_t>( wrap( rel[i] + static_cast<int>(cur[i]), i) );
+    }
+    return corgi::internals::into_tuple(cur);
+  }
+
   /// Return full Moore neighborhood around me
-  std::vector< corgi::internals::tuple_of<D, size_t> > nhood(
+  std::array< corgi::internals::tuple_of<D, size_t>, corgi::ca::moore_size<D>() > nhood(
       corgi::internals::tuple_of<D, size_t> indices)
   {
-    std::vector< corgi::internals::tuple_of<D, size_t> > nh;
-    if(D == 1) nh.reserve(2);
-    if(D == 2) nh.reserve(8);
-    if(D == 3) nh.reserve(26);
+    static constexpr auto stencil = corgi::ca::moore_stencil<D>();
 
-    for(auto& reli : corgi::ca::moore_neighborhood<D>() ){
-      nh.push_back( neighs(indices, reli) );
-    }
+    std::array< corgi::internals::tuple_of<D, size_t>, stencil.size() > nh;
+    for(size_t n=0; n<stencil.size(); n++) nh[n] = neighs(indices, stencil[n]);
     return nh;
   }
 
 
-  void adoption_council2()
-  {
-    adoptions.clear();
-    kidnaps.clear();
-    std::vector<double> alives(comm.size());
-
-    //int myrank = comm.rank();
+  private:
 
-    // for updated values
-    corgi::tools::sparse_grid<int, D> new_mpi_grid(_mpi_grid);
+  /// \brief Propagate the CA rule one step and return the accepted moves
+  //
+  // Moves are (flat position, new color) pairs in position order. With
+  // only_mine the rule is evaluated just for the frontier tiles I own, 
+  // found from my tile list; _mpi_grid is then only read within a kernel 
+  // radius of my tiles.
+  std::vector<std::pair<uint64_t, int>> _council_moves(bool only_mine)
+  {
+    // color scores; only the colors present around a tile are non-zero
+    std::vector<double> alives(comm.size(), 0.0);
+    std::vector<int> present;
+
+    // only frontier tiles can change color
+    std::vector<uint64_t> my_frontier;
+    if(only_mine) {
+      for(auto cid : _local_tiles) {
+        auto& ind = get_tile(cid).index;
+        if(_on_frontier(ind)) my_frontier.push_back( _flat_position(ind) );
+      }
+      std::sort(my_frontier.begin(), my_frontier.end());
+    } else if(_frontier_dirty) {
+      _build_frontier();
+    }
+    const auto& frontier = only_mine ? my_frontier : _frontier;
 
-    // radius of Gaussian kernel
-    int Ng = sqrt(*std::max_element(_lengths.begin(), _lengths.end() )); 
-    //int Ng = *std::max_element(_lengths.begin(), _lengths.end() )/2; 
-    auto Rg = static_cast<double>(Ng);
+    // tentative new colors (flat position, color)
+    std::vector<std::pair<uint64_t, int>> changes;
 
-    // gaussian kernel; i.e., relative indices how we convolve
-    auto kernel = corgi::ca::chessboard_neighborhood<D>(Ng);
+    // Gaussian kernel and flat ownership grid
+    const auto& kernel = _council_kernel();
+    std::vector<int> scratch;
+    const int* owners = _owner_array(scratch);
 
 
     // keep track of tile changes
@@ -1316,83 +2229,69 @@ class Grid
     std::fill(obtained.begin(), obtained.end(), 0); // reset vector
     std::fill(lost.begin(), lost.end(), 0); // reset vector
 
-    // transferred work
-    std::vector<double> transfers(comm.size());
-    std::fill(transfers.begin(), transfers.end(), 0.0); // reset vector
-
     // absolute quota in units of work
     std::vector<double> quota(comm.size());
     for(int rank=0; rank<comm.size(); rank++) quota[rank] = get_quota(rank);
 
     // relative quota
     std::vector<double> rel_quota(comm.size());
-    double total_work = 0.0;
-    for(auto& elem : _work_grid) total_work += elem.second;
+    double total_work = _total_work;
     for(size_t i=0; i<rel_quota.size(); i++) rel_quota[i] = comm.size()*quota[i]/total_work;
 
     //std::cout << comm.rank() << ": my quota : " << quota[myrank] 
     //  << " (" << rel_quota[myrank] << ")"
     //  << "\n";
 
-    //--------------------------------------------------
-    // normalization of multidimensional univariate normal distribution
-    //double norm = 0.25/M_PI;
-    double norm = 1.0/sqrt(std::pow(2.0*M_PI, D)*Rg*Rg);
+    // Colors absent from the kernel score only by their quota, so the
+    // best of them is the first color with maximal quota.
+    int quota_color = std::distance( rel_quota.begin(), 
+        std::max_element(rel_quota.begin(), rel_quota.end()));
 
 
-    // process the complete grid (including remote neighbors)
+    // process the frontier (of the complete grid unless only_mine)
     int new_color;
-    for(auto&& elem : _mpi_grid) {
-      auto& ind     = elem.first;
-      int old_color = elem.second;
-
-      std::fill(alives.begin(), alives.end(), 0.0); // reset vector
+    for(auto pos : frontier) {
+      auto ind      = corgi::internals::into_array( _flat_index(pos) );
+      int old_color = owners[pos];
 
       // resolve neighborhood; diffusion step
-      alives[old_color] = norm;
-
-      // Limited Moore nearest neighborhood
-      //auto neigs = nhood(ind);
-      //for(auto& nindx : neigs) {
-      //  color = _mpi_grid(nindx);
-      //  assert(0 <= color && color < comm.size());
-
-      //  alives[color]++; 
-      //}
-
+      present.clear();
+      present.push_back(old_color);
+      alives[old_color] = kernel.norm;
 
       // full Gaussian kernel
-      double r;
       int color;
-      for(auto& reli : kernel ) {
-        auto nindx = neighs(ind, reli);
-        color = _mpi_grid(nindx);
-
-        //r = geom::eulerian_distance(reli);  
-        r = static_cast<double>( geom::manhattan_distance<D>(reli) );  
-        //r = geom::chessboard_distance<D>(reli);  
+      for(size_t k=0; k<kernel.weights.size(); k++) {
+        color = owners[ kernel.position(ind, k) ];
+        if(alives[color] == 0.0) present.push_back(color);
 
-        alives[color] += norm*exp(-0.5*r*r/Rg/Rg);
+        alives[color] += kernel.weights[k];
       }
 
-
-      // normalize
+      // normalize; summed in color order
+      std::sort(present.begin(), present.end());
       double loop_norm = 0.0;
-      for(auto& val : alives) loop_norm += val;
-      for(auto& val : alives) val /= loop_norm;
-
-      // add relative quota for balance 
-      for(size_t i=0; i<alives.size(); i++) alives[i] += 0.5*rel_quota[i];
+      for(int c : present) loop_norm += alives[c];
+
+      // get mode, i.e., most frequent color, after adding the relative 
+      // quota for balance; sharpening step
+      new_color = quota_color;
+      double best = 0.5*rel_quota[quota_color];
+      for(int c : present) {
+        double val = alives[c]/loop_norm + 0.5*rel_quota[c];
+        if( (val > best) || (val == best && c < new_color) ) {
+          best      = val;
+          new_color = c;
+        }
+        alives[c] = 0.0;
+      }
 
-      // get mode, i.e., most frequent color; sharpening step
-      new_color = std::distance( alives.begin(), 
-          std::max_element(alives.begin(), alives.end()));
+      // progress one step
+      if(new_color == old_color) continue;
 
       obtained[new_color]++;
       lost[old_color]++;
-
-      // progress one step
-      new_mpi_grid(ind) = new_color;
+      changes.emplace_back(pos, new_color);
     }
 
     //std::cout << comm.rank() << ": rank gained/lost= " 
@@ -1403,22 +2302,19 @@ class Grid
     //--------------------------------------------------
 
 
-    // next, process changes of ownership
-    for(auto&& elem : _mpi_grid) {
-      auto& ind     = elem.first;
-      int old_color = elem.second;
-      int new_color = new_mpi_grid(ind);
-      uint64_t cid = id(ind);
-
-      // if no changes, then skip everything
-      if(new_color == old_color) continue;
-
+    // next, filter the changes of ownership; 
+    // accepted moves are written to _mpi_grid only after the sweep
+    std::vector<std::pair<uint64_t, int>> accepted;
+    for(auto& change : changes) {
+      auto ind      = _flat_index(change.first);
+      int new_color = change.second;
 
       // check that velocity is not too great; 
       // i.e., change of boundary happens via virtual tiles
       bool is_virtual = false;
       int color;
-      for(auto& reli : corgi::ca::moore_neighborhood<D>() ){
+      static constexpr auto moore = corgi::ca::moore_stencil<D>();
+      for(auto& reli : moore){
         auto nindx = neighs(ind, reli);
         color = _mpi_grid(nindx);
         if(color == new_color) {
@@ -1429,12 +2325,37 @@ class Grid
 
       // abort if this is not virtual
       if(!is_virtual) {
-        //std::cout << comm.rank() << ": XXX tile " << cid 
+        //std::cout << comm.rank() << ": XXX tile " << id(ind) 
         //    << " is going too fast to: " << new_color << "\n";
-        new_mpi_grid(ind) = old_color;
         continue;
       }
-        
+      accepted.push_back(change);
+    }
+
+    return accepted;
+  }
+
+
+  /// \brief Process ownership changes decided by the council
+  //
+  // With every_move every rank applies the same moves so that the 
+  // replicated _mpi_grid (and the loads and frontier derived from it) 
+  // stay in sync. Otherwise only _mpi_grid and my tiles are updated and 
+  // the caller takes care of the loads.
+  void _apply_council_moves(
+      const std::vector<std::pair<uint64_t, int>>& moves, 
+      bool every_move = true)
+  {
+    // transferred work
+    std::vector<double> transfers(comm.size());
+    std::fill(transfers.begin(), transfers.end(), 0.0); // reset vector
+
+    for(auto& change : moves) {
+      auto ind      = _flat_index(change.first);
+      int old_color = _mpi_grid(ind);
+      int new_color = change.second;
+      uint64_t cid = id(ind);
+
       // keep track of work / individual load
       transfers[new_color] += _work_grid(ind);
 
@@ -1456,6 +2377,7 @@ class Grid
         //    //<< " at " << tile.communication.indices[0] << " " << tile.communication.indices[1] << "\n";
         auto& tile  = get_tile(cid);
         tile.communication.owner = comm.rank();
+        _classify_tile(cid);
 
 
         // A tile has been kidnapped from me
@@ -1465,6 +2387,7 @@ class Grid
         if(is_local(cid)) {
           auto& tile  = get_tile(cid);
           tile.communication.owner = new_color;
+          _classify_tile(cid);
 
           // FIXME
           //std::cout << comm.rank() << ": oh gosh tile " << cid << " is mine! \n";
@@ -1478,9 +2401,156 @@ class Grid
     } // end of loop over elements
 
 
-    // global progress
-    _mpi_grid = std::move(new_mpi_grid);
- }
+    // global progress; frontier only changes around the moved tiles
+    static constexpr auto moore = corgi::ca::moore_stencil<D>();
+    for(auto& change : moves) {
+      auto ind = _flat_index(change.first);
+      if(every_move) _move_load(ind, _mpi_grid(ind), change.second);
+      _mpi_grid(ind) = change.second;
+    }
+
+    if(!every_move) {
+      _frontier_dirty = true;
+    } else if(!_frontier_dirty) {
+      for(auto& change : moves) {
+        auto ind = _flat_index(change.first);
+        _refresh_frontier(ind);
+        for(auto& reli : moore) _refresh_frontier( neighs(ind, reli) );
+      }
+    }
+
+    if(!moves.empty()) {
+      _nhoods_dirty   = true;
+      _schedule_dirty = true;
+    }
+  }
+
+
+  public:
+
+  /// Propagate CA rules one step forward and decide who adopts who
+  //
+  // Every rank evaluates the whole (frontier of the) grid and comes to 
+  // the same conclusion without communication.
+  void adoption_council2()
+  {
+    adoptions.clear();
+    kidnaps.clear();
+
+    _apply_council_moves( _council_moves(false) );
+  }
+
+  /// \brief Distributed version of adoption_council2
+  //
+  // Each rank evaluates the rule only for its own frontier tiles. A move 
+  // is sent to the ranks that own a tile within the kernel around it; 
+  // nobody else reads it in their next evaluation. The new owner also 
+  // gets the current owners within the kernel so that its _mpi_grid 
+  // stays exact around every tile it owns. Each move carries the work of 
+  // the tile so that the loads of the ranks involved are updated without 
+  // a global reduction; loads of ranks further away are refreshed by the 
+  // next allgather_work_grid.
+  //
+  // Results are identical to adoption_council2 but the cost follows the 
+  // local tile count. Afterwards _mpi_grid is only exact within a kernel 
+  // radius of my tiles; global owner lookups (owner_at) are refused 
+  // until allgather_mpi_grid has rebuilt the full grid. Collective; all 
+  // ranks must call it.
+  void adoption_council_distributed()
+  {
+    adoptions.clear();
+    kidnaps.clear();
+
+    const int myrank = comm.rank();
+    const auto& kernel = _council_kernel();
+    std::vector<int> scratch;
+
+    auto mine = _council_moves(true);
+
+    // work changes hands only in the moves; every rank sees its own
+    // and those of its neighbors that are within the kernel
+    auto shift_load = [&](int from, int to, double work) {
+      if(_loads_dirty) return;
+      _loads[from] -= work;
+      _loads[to]   += work;
+    };
+
+    // my moves to everybody whose kernel can reach them
+    std::map<int, std::vector<char>> outgoing;
+    std::vector<int> dests;
+    const int* owners = _owner_array(scratch);
+    for(auto& move : mine) {
+      auto ind = corgi::internals::into_array( _flat_index(move.first) );
+
+      dests.clear();
+      for(size_t k=0; k<kernel.weights.size(); k++) {
+        int rank = owners[ kernel.position(ind, k) ];
+        if(rank != myrank) dests.push_back(rank);
+      }
+      std::sort(dests.begin(), dests.end());
+      dests.erase( std::unique(dests.begin(), dests.end()), dests.end() );
+
+      double work = _work_grid( _flat_index(move.first) );
+      shift_load(myrank, move.second, work);
+
+      for(int rank : dests) {
+        tools::byte_writer buf(outgoing[rank]);
+        buf.put(move.first);
+        buf.put_varint(move.second);
+        buf.put(work);
+      }
+    }
+
+    auto moves = mine;
+    tools::sparse_exchange(comm, commType::COUNCIL_MOVES, outgoing,
+      [&](int orig, const std::vector<char>& bytes) 
+      {
+        tools::byte_reader buf(bytes.data(), bytes.size());
+        while(!buf.empty()) {
+          auto pos   = buf.get<uint64_t>();
+          int  color = static_cast<int>(buf.get_varint());
+          shift_load(orig, color, buf.get<double>());
+          moves.emplace_back(pos, color);
+        }
+      });
+
+    // same (position) order as in the replicated council
+    std::sort(moves.begin(), moves.end());
+
+    _apply_council_moves(moves, false);
+    _owners_partial = true;
+
+    // current owners around the tiles I gave away
+    outgoing.clear();
+    owners = _owner_array(scratch);
+    for(auto& move : mine) {
+      auto ind = corgi::internals::into_array( _flat_index(move.first) );
+
+      tools::byte_writer buf(outgoing[move.second]);
+      buf.put(move.first);
+      for(size_t k=0; k<kernel.weights.size(); k++) {
+        buf.put_varint( owners[ kernel.position(ind, k) ] );
+      }
+    }
+
+    tools::sparse_exchange(comm, commType::COUNCIL_OWNERS, outgoing,
+      [&](int /*orig*/, const std::vector<char>& bytes) 
+      {
+        tools::byte_reader buf(bytes.data(), bytes.size());
+        while(!buf.empty()) {
+          auto ind = corgi::internals::into_array( _flat_index( buf.get<uint64_t>() ) );
+
+          for(size_t k=0; k<kernel.weights.size(); k++) {
+            int& color = _mpi_grid( _flat_index( kernel.position(ind, k) ) );
+            auto owner = static_cast<int>(buf.get_varint());
+            if(color == owner) continue;
+
+            color = owner;
+            _nhoods_dirty = true;
+          }
+        }
+      });
+  }
 
 
   /// iterate over tiles in adoption vector and claim them to me
@@ -1497,7 +2567,8 @@ class Grid
       vir.communication.owner = comm.rank();
       //vir.communication.local = true;
 
-      _mpi_grid( vir.index ) = comm.rank();
+      _set_owner( vir.index, comm.rank() );
+      _classify_tile(cid);
     }
   }
 
@@ -1510,13 +2581,22 @@ class Grid
 
     // ensure that adoptions vector is of standard length
     //if(adoptions.size() < max_quota) adoptions.resize(max_quota);
-    while((int)adoptions.size() < max_quota) adoptions.push_back(-1);
+    while((int)adoptions.size() < max_quota) adoptions.push_back(_no_cid);
+
+    if(compact_metainfo) _encode_cids(adoptions, static_cast<size_t>(max_quota), adoption_bytes);
 
     for (int dest = 0; dest<comm.size(); dest++) {
       if( dest == comm.rank() ) { continue; } // do not send to myself
 
       mpi::request req;
-      req = comm.isend(dest, commType::ADOPT, adoptions.data(), max_quota);
+      if(compact_metainfo) {
+        req = comm.isend(dest, 
+            commType::ADOPT, 
+            adoption_bytes.data(), 
+            static_cast<int>(adoption_bytes.size()) );
+      } else {
+        req = comm.isend(dest, commType::ADOPT, adoptions.data(), max_quota);
+      }
       sent_adoption_messages.push_back( req );
     }
   }
@@ -1529,6 +2609,9 @@ class Grid
     // ensure that the receiving array is of correct size
     kidnaps.resize(comm.size()*max_quota);
 
+    // compact messages have variable length; received in wait_adoptions
+    if(compact_metainfo) return;
+
     for (int orig = 0; orig<comm.size(); orig++) {
       if( orig == comm.rank() ) { continue; } // do not recv from myself
 
@@ -1545,18 +2628,31 @@ class Grid
   // even if they are remote and do not consider me.
   void wait_adoptions()
   {
+    // probe and receive compact messages
+    if(compact_metainfo) {
+      std::vector<int> origs;
+      for (int orig = 0; orig<comm.size(); orig++) {
+        if( orig != comm.rank() ) origs.push_back(orig); // do not recv from myself
+      }
+
+      _recv_bytes(origs, commType::ADOPT, 
+          [&](int orig, const std::vector<char>& bytes) {
+            _decode_cids(bytes.data(), bytes.size(), &kidnaps[orig*max_quota], static_cast<size_t>(max_quota));
+          });
+    }
+
     // wait
     mpi::wait_all(recv_adoption_messages.begin(), recv_adoption_messages.end());
     mpi::wait_all(sent_adoption_messages.begin(), sent_adoption_messages.end());
 
     // unpack
-    int kidnapped_cid;
+    uint64_t kidnapped_cid;
     for (int orig = 0; orig<comm.size(); orig++) {
       if( orig == comm.rank() ) { continue; } // do not process myself
 
       for(int i=0; i<max_quota; i++) {
         kidnapped_cid = kidnaps[orig*max_quota + i];
-        if(kidnapped_cid == -1) continue;
+        if(kidnapped_cid == _no_cid) continue;
 
         auto index = id2index(kidnapped_cid, _lengths);
 
@@ -1570,10 +2666,11 @@ class Grid
           auto& tile = get_tile(kidnapped_cid);
           tile.communication.owner = orig;
           //tile.communication.local = false;
+          _classify_tile(kidnapped_cid);
         }
 
         // update global status irrespective of if it is mine or not
-        _mpi_grid(index) = orig;
+        _set_owner(index, orig);
       }
     }
   }
@@ -1592,7 +2689,10 @@ class Grid
   {
 
     int whoami;
-    for(auto cid : get_virtuals() ) {
+
+    // copy; classification lists are modified during the loop
+    std::vector<uint64_t> virtuals = get_virtuals();
+    for(auto cid : virtuals ) {
 
       // check if virtual tile is still needed
       auto& c = get_tile(cid);
@@ -1602,13 +2702,43 @@ class Grid
         if(whoami == comm.rank()) continue;
       }
 
+      // take the tile out of the storage and recycle it
+      Tileptr tileptr = tiles.at(cid);
       tiles.erase(cid);
+      _unclassify_tile(cid);
+      _retire_tile( std::move(tileptr) );
     }
   }
 
+  /// remove only the virtual tiles that are not in the halo of my tiles
+  //
+  // Virtual tiles next to my tiles are kept so that the next recv_tiles
+  // only updates them; the rest go back to the tile pool.
+  void erase_stale_virtuals()
+  {
 
-  // --------------------------------------------------
-  // user-data message routines
+    // collected first since classification lists are modified below
+    std::vector<uint64_t> stale;
+    for(auto cid : get_virtuals() ) {
+      auto& nh = get_neighborhood(cid);
+      if(std::find(nh.owners.begin(), nh.owners.end(), comm.rank()) == nh.owners.end()) {
+        stale.push_back(cid);
+      }
+    }
+
+    for(auto cid : stale) {
+
+      // take the tile out of the storage and recycle it
+      Tileptr tileptr = tiles.at(cid);
+      tiles.erase(cid);
+      _unclassify_tile(cid);
+      _retire_tile( std::move(tileptr) );
+    }
+  }
+
+
+  // --------------------------------------------------
+  // user-data message routines
 
   /// Initialize vector of vector if needed
   //void initialize_message_array(
@@ -1626,31 +2756,26 @@ class Grid
   //       this way methods can be extended for different types of send.
   void send_data(int mode)
   {
+    _update_schedule();
     sent_data_messages[mode] = {};
 
-    
-    // re-order sends and compute mpi tags
-    std::map<int, std::vector<uint64_t> > tags;
-    for(auto cid : get_boundary_tiles() ) {
-      auto& tile = get_tile(cid);
+    // one message per rank holding all the tiles in cid order
+    if(data_exchange != exchangeType::PER_TILE) {
+      if(shared_memory) _send_shared_data(mode);
 
-      // TODO proceed only if tile is active 
-      for(auto dest: tile.virtual_owners) {
-        tags[dest].push_back(cid);
+      if(data_transport == transportType::NEIGHBOR_COLLECTIVE) {
+        _send_neighbor_data(mode);
+      } else if(data_transport == transportType::ONE_SIDED) {
+        _send_rma_data(mode);
+      } else {
+        _send_aggregated_data(mode);
       }
+      return;
     }
-    for(auto& elem : tags) sort(elem.second.begin(), elem.second.end());
-
-    // print
-    //for(auto& elem : tags) {
-    //  std::cout << comm.rank() << ": S:" << elem.first << " --- ";
-    //  for(auto& c : elem.second) std::cout << c << ", ";
-    //  std::cout << "\n";
-    //}
 
     int dest;
     uint64_t cid;
-    for(auto& elem : tags) {
+    for(auto& elem : send_schedule) {
       dest = elem.first;
       for(int i = 0; i<(int)elem.second.size(); i++) {
         cid = elem.second[i];
@@ -1660,15 +2785,6 @@ class Grid
         for(auto req : reqs) sent_data_messages.at(mode).push_back(req);
       }
     }
-
-    //for(auto cid : get_boundary_tiles() ) {
-    //  auto& tile = get_tile(cid);
-    //  for(auto dest: tile.communication.virtual_owners) {
-    //    auto reqs = tile.send_data(comm, dest, mode);
-    //    
-    //    for(auto req : reqs) sent_data_messages.at(mode).push_back(req);
-    //  }
-    //}
   }
 
 
@@ -1677,29 +2793,24 @@ class Grid
   //       this way they can be extended for different types of recv.
   void recv_data(int mode)
   {
+    _update_schedule();
     recv_data_messages[mode] = {};
 
-    // re-order sends and compute mpi tags
-    std::map<int, std::vector<uint64_t> > tags;
-    for(auto cid : get_virtuals() ) {
-      auto& tile = get_tile(cid);
+    // fixed-size messages are received into persistent buffers; 
+    // others are probed and unpacked in wait_data
+    if(data_exchange != exchangeType::PER_TILE) {
+      if(data_transport != transportType::POINT_TO_POINT) return;
 
-      //TODO: proceed only if tile is active
-      tags[tile.communication.owner].push_back(cid);
+      auto& plan = _recv_plan(mode);
+      if(plan.fixed && !plan.reqs.empty()) {
+        MPI_Startall(static_cast<int>(plan.reqs.size()), plan.reqs.data());
+      }
+      return;
     }
-    for(auto& elem : tags) sort(elem.second.begin(), elem.second.end());
-
-    // print
-    //for(auto& elem : tags) {
-    //  std::cout << comm.rank() << ": R:" << elem.first << " --- ";
-    //  for(auto& c : elem.second) std::cout << c << ", ";
-    //  std::cout << "\n";
-    //}
-
 
     int orig;
     uint64_t cid;
-    for(auto& elem : tags) {
+    for(auto& elem : recv_schedule) {
       orig = elem.first;
       for(int i = 0; i<(int)elem.second.size(); i++) {
         cid = elem.second[i];
@@ -1710,16 +2821,6 @@ class Grid
       }
     }
 
-    //int nc = 0, nv = 0;
-    //for(auto cid : get_virtuals() ) {
-    //  auto& tile = get_tile(cid);
-    //  auto reqs = tile.recv_data(comm, tile.communication.owner, mode);
-
-    //  for(auto req : reqs) recv_data_messages.at(mode).push_back(req);
-    //  //nc += reqs.size();
-    //  //nv++;
-    //}
-
     //std::cout << comm.rank() << ": recv buffer size " << nc << " nv: " << nv << "\n";
   }
 
@@ -1729,8 +2830,35 @@ class Grid
     //assert( tag < (int)recv_data_messages.size() );
     assert( sent_data_messages.count(tag) > 0 );
     assert( recv_data_messages.count(tag) > 0 );
+
+    if(data_exchange != exchangeType::PER_TILE) {
+      if(data_transport == transportType::NEIGHBOR_COLLECTIVE) {
+        _wait_neighbor_data(tag);
+      } else if(data_transport == transportType::ONE_SIDED) {
+        _wait_rma_data(tag);
+      } else {
+        _recv_aggregated_data(tag);
+
+        auto& plan = _send_plan(tag);
+        if(plan.fixed && !plan.reqs.empty()) {
+          MPI_Waitall(static_cast<int>(plan.reqs.size()), plan.reqs.data(), MPI_STATUSES_IGNORE);
+        }
+      }
+
+      if(shared_memory) _wait_shared_data(tag);
+    }
     
     mpi::wait_all( recv_data_messages[tag].begin(), recv_data_messages[tag].end() );
+
+    // let tiles finish receives that could not be posted up front
+    if(data_exchange == exchangeType::PER_TILE) {
+      for(auto& elem : recv_schedule) {
+        for(int i = 0; i<(int)elem.second.size(); i++) {
+          get_tile(elem.second[i]).wait_data(comm, elem.first, tag, i);
+        }
+      }
+    }
+
     mpi::wait_all( sent_data_messages[tag].begin(), sent_data_messages[tag].end() );
     //for(auto& req : recv_data_messages[tag]) req.wait();
 
@@ -1758,6 +2886,962 @@ class Grid
     
   }
 
+  /*! Force rebuild of the data exchange schedule on next use.
+   *
+   * The schedule is rebuilt automatically after analyze_boundaries and 
+   * whenever tiles are added, removed or change owner; call this if the 
+   * sizes reported by Tile::packed_size change. Persistent requests 
+   * are released right away so this must not be called while a data 
+   * exchange is in progress.
+   *
+   * NOTE: with the neighbor-collective transport all ranks have to call 
+   * this together since message sizes are then agreed on again.
+   */
+  void invalidate_schedule() 
+  { 
+    _free_plans();
+    _neighbor_fixed.clear();
+    _schedule_dirty = true; 
+  }
+
+
+  private:
+
+  /// are send_schedule/recv_schedule (and the persistent plans) out of date
+  bool _schedule_dirty = true;
+
+  /*! Message buffers and requests of one aggregated exchange direction.
+   *
+   * If every tile reports a fixed packed size the buffers are allocated 
+   * once with their final size and bound to persistent requests 
+   * (MPI_Send_init/MPI_Recv_init) that are only restarted every step.
+   */
+  struct Exchange_plan {
+
+    /// exchangeType the plan was built for
+    int exchange = exchangeType::PER_TILE;
+
+    /// transportType the plan was built for
+    int transport = transportType::POINT_TO_POINT;
+
+    /// were same-node ranks left to the shared-memory path
+    bool shared = false;
+
+    /// do all messages have a size known in advance
+    bool fixed = false;
+
+    /// peer ranks; same order as in the schedule
+    std::vector<int> ranks;
+
+    /// one message buffer per peer
+    std::vector<std::vector<char>> bufs;
+
+    /// persistent requests (only if fixed)
+    std::vector<MPI_Request> reqs;
+
+    /// contiguous message buffer of the neighbor collective; 
+    /// segment r is [displs[r], displs[r]+counts[r])
+    std::vector<char> packed;
+    std::vector<int> counts;
+    std::vector<int> displs;
+  };
+
+  /// aggregated exchange plans per mode; built lazily from the schedule
+  std::unordered_map<int, Exchange_plan> _send_plans;
+  std::unordered_map<int, Exchange_plan> _recv_plans;
+
+  /// distributed graph communicator over the neighbor ranks
+  MPI_Comm _graph_comm = MPI_COMM_NULL;
+
+  /// in-neighbors (virtual tile owners) and out-neighbors of _graph_comm
+  std::vector<int> _graph_sources;
+  std::vector<int> _graph_dests;
+
+  /// has analyze_boundaries changed the rank topology since the graph was built
+  bool _graph_dirty = true;
+
+  /// has analyze_boundaries been called since the ranks last agreed on the topology
+  bool _topology_pending = false;
+
+  /// has my rank topology changed since then
+  bool _topology_changed = false;
+
+  /*! Invalidate the graph and windows if the rank topology changed anywhere.
+   *
+   * analyze_boundaries only records the change of my own topology; the 
+   * graph and windows are rebuilt collectively so all ranks have to agree 
+   * on whether any of them changed.
+   *
+   * NOTE: collective over all ranks; it happens at the first send_data or
+   * recv_data after analyze_boundaries with a transport that keeps such
+   * state. Point-to-point exchanges never synchronize.
+   */
+  void _sync_topology()
+  {
+    if(!_topology_pending) return;
+    if(data_exchange == exchangeType::PER_TILE) return;
+    if(data_transport == transportType::POINT_TO_POINT && !shared_memory) return;
+
+    int any_changed = _topology_changed ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &any_changed, 1, MPI_INT, MPI_LOR, comm);
+
+    if(any_changed) {
+      _graph_dirty = true;
+      for(auto& elem : _windows)     elem.second.stale = true;
+      for(auto& elem : _shm_windows) elem.second.stale = true;
+    }
+
+    _topology_pending = false;
+    _topology_changed = false;
+  }
+
+  /*! Rebuild the neighbor graph communicator.
+   *
+   * NOTE: this is collective over all ranks; it happens at the first 
+   * send_data after analyze_boundaries (which all ranks call together).
+   */
+  void _update_graph()
+  {
+    if(!_graph_dirty) return;
+
+    if(_graph_comm != MPI_COMM_NULL) MPI_Comm_free(&_graph_comm);
+
+    _graph_sources.clear();
+    for(auto&& elem : virtual_tile_list) _graph_sources.push_back(elem.first);
+
+    std::set<int> dests;
+    for(auto&& elem : boundary_tile_list) dests.insert(elem.second.begin(), elem.second.end());
+    _graph_dests.assign(dests.begin(), dests.end());
+
+    MPI_Dist_graph_create_adjacent(comm,
+        static_cast<int>(_graph_sources.size()), _graph_sources.data(), MPI_UNWEIGHTED,
+        static_cast<int>(_graph_dests.size()),   _graph_dests.data(),   MPI_UNWEIGHTED,
+        MPI_INFO_NULL, 
+        0, // keep ranks
+        &_graph_comm);
+
+    // plans refer to the old graph ordering
+    _free_plans();
+    _neighbor_fixed.clear();
+
+    _graph_dirty = false;
+  }
+
+  /*! One-sided exchange window of one mode.
+   *
+   * Every rank exposes one segment per origin rank in its window; the 
+   * origins put their packed tiles directly into it. Layout is fixed 
+   * when the window is built so all payloads must be of fixed size.
+   */
+  struct Rma_window {
+
+    /// needs to be rebuilt (topology has changed)
+    bool stale = false;
+
+    /// exchangeType the layout was built for
+    int exchange = exchangeType::PER_TILE;
+
+    /// were same-node ranks left to the shared-memory path
+    bool shared = false;
+
+    MPI_Win win = MPI_WIN_NULL;
+
+    /// ranks putting into my window / ranks whose windows I put into
+    MPI_Group exposure = MPI_GROUP_NULL;
+    MPI_Group access   = MPI_GROUP_NULL;
+
+    /// window memory and the segment of every origin rank
+    std::vector<char> recv;
+    std::vector<int> sources;
+    std::vector<MPI_Aint> recv_displs;
+    std::vector<MPI_Aint> recv_lens;
+
+    /// outgoing buffers and where they go in the target windows
+    std::vector<int> dests;
+    std::vector<std::vector<char>> send_bufs;
+    std::vector<size_t> send_lens;
+    std::vector<MPI_Aint> target_displs;
+  };
+
+  /// one-sided exchange windows per mode
+  std::unordered_map<int, Rma_window> _windows;
+
+  /// release MPI objects of a window; collective over all ranks
+  static void _free_window(Rma_window& w)
+  {
+    if(w.win != MPI_WIN_NULL) MPI_Win_free(&w.win);
+    for(auto* g : {&w.exposure, &w.access}) {
+      if(*g != MPI_GROUP_NULL && *g != MPI_GROUP_EMPTY) MPI_Group_free(g);
+      *g = MPI_GROUP_NULL;
+    }
+  }
+
+  /*! (Re)build the window of mode if needed.
+   *
+   * NOTE: this is collective over all ranks; it happens at the first 
+   * send_data(mode) after analyze_boundaries (which all ranks call together).
+   */
+  Rma_window& _update_window(int mode)
+  {
+    auto it = _windows.find(mode);
+    if(it != _windows.end() && 
+        !it->second.stale && 
+        it->second.exchange == data_exchange && 
+        it->second.shared == shared_memory) {
+      return it->second;
+    }
+
+    auto& w = _windows[mode];
+    _free_window(w);
+    w = Rma_window();
+    w.exchange = data_exchange;
+    w.shared   = shared_memory;
+
+    // one segment per origin rank
+    MPI_Aint total = 0;
+    for(auto& elem : recv_schedule) {
+      if(_via_shared(elem.first)) continue;
+
+      auto len = _fixed_message_size(elem.second, mode, comm.rank());
+      if(len == 0) throw std::runtime_error("one-sided transport needs fixed-size tile payloads");
+
+      w.sources.push_back(elem.first);
+      w.recv_displs.push_back(total);
+      w.recv_lens.push_back( static_cast<MPI_Aint>(len) );
+      total += static_cast<MPI_Aint>(len);
+    }
+    w.recv.resize( static_cast<size_t>(total) );
+
+    MPI_Win_create(w.recv.data(), total, 1, MPI_INFO_NULL, comm, &w.win);
+
+    for(auto& elem : send_schedule) {
+      if(_via_shared(elem.first)) continue;
+
+      auto len = _fixed_message_size(elem.second, mode, elem.first);
+      if(len == 0) throw std::runtime_error("one-sided transport needs fixed-size tile payloads");
+
+      w.dests.push_back(elem.first);
+      w.send_lens.push_back(len);
+      w.send_bufs.emplace_back();
+      w.send_bufs.back().reserve(len);
+    }
+
+    // tell every origin where its segment is (and how long we expect it to be)
+    std::vector<MPI_Request> reqs(w.sources.size());
+    std::vector<std::array<MPI_Aint,2>> segs(w.sources.size());
+    for(size_t r=0; r<w.sources.size(); r++) {
+      segs[r] = {{ w.recv_displs[r], w.recv_lens[r] }};
+      MPI_Isend(segs[r].data(), 2, MPI_AINT, w.sources[r], _data_tag(mode), comm, &reqs[r]);
+    }
+
+    w.target_displs.resize(w.dests.size());
+    for(size_t r=0; r<w.dests.size(); r++) {
+      std::array<MPI_Aint,2> seg;
+      MPI_Recv(seg.data(), 2, MPI_AINT, w.dests[r], _data_tag(mode), comm, MPI_STATUS_IGNORE);
+      assert( static_cast<size_t>(seg[1]) == w.send_lens[r] );
+      w.target_displs[r] = seg[0];
+    }
+    MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE);
+
+    MPI_Group group;
+    MPI_Comm_group(comm, &group);
+    MPI_Group_incl(group, static_cast<int>(w.sources.size()), w.sources.data(), &w.exposure);
+    MPI_Group_incl(group, static_cast<int>(w.dests.size()),   w.dests.data(),   &w.access);
+    MPI_Group_free(&group);
+
+    return w;
+  }
+
+  /// ranks on my node; MPI_COMM_NULL until first needed
+  MPI_Comm _node_comm = MPI_COMM_NULL;
+
+  /// rank in _node_comm of every grid rank (-1 if on another node)
+  std::vector<int> _node_ranks;
+
+  /// is data to/from rank exchanged via shared memory
+  bool _via_shared(int rank) const
+  {
+    return shared_memory && 
+      !_node_ranks.empty() && 
+      rank != comm.rank() && 
+      _node_ranks[rank] >= 0;
+  }
+
+  /*! Find the ranks on my node once shared_memory is switched on.
+   *
+   * NOTE: collective over all ranks; it happens at the first send_data or
+   * recv_data (whichever comes first) after shared_memory is set.
+   */
+  void _update_node_comm()
+  {
+    if(!shared_memory || _node_comm != MPI_COMM_NULL) return;
+
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &_node_comm);
+
+    int nranks = comm.size();
+    std::vector<int> grid_ranks(nranks);
+    for(int r=0; r<nranks; r++) grid_ranks[r] = r;
+    _node_ranks.resize(nranks);
+
+    MPI_Group group, node;
+    MPI_Comm_group(comm, &group);
+    MPI_Comm_group(_node_comm, &node);
+    MPI_Group_translate_ranks(group, nranks, grid_ranks.data(), node, _node_ranks.data());
+    MPI_Group_free(&group);
+    MPI_Group_free(&node);
+
+    for(auto& r : _node_ranks) if(r == MPI_UNDEFINED) r = -1;
+
+    // anything built without the node map routes same-node ranks wrong
+    _free_plans();
+    for(auto& elem : _windows)     elem.second.stale = true;
+    for(auto& elem : _shm_windows) elem.second.stale = true;
+  }
+
+  /*! Shared-memory exchange segment of one mode.
+   *
+   * Segment of every rank is double-buffered: step k writes half k%2 so 
+   * that one node barrier per step is enough; a rank can only start 
+   * writing the half again after everyone has passed the barrier that 
+   * follows the previous read of it.
+   */
+  struct Shm_window {
+
+    /// needs to be rebuilt (topology has changed)
+    bool stale = false;
+
+    /// exchangeType the layout was built for
+    int exchange = exchangeType::PER_TILE;
+
+    MPI_Win win = MPI_WIN_NULL;
+
+    /// my segment and the size of one of its halves
+    char* base = nullptr;
+    size_t half = 0;
+
+    /// which half is written this step
+    int parity = 0;
+
+    /// my outgoing blocks within my segment
+    std::vector<int> dests;
+    std::vector<size_t> send_displs;
+    std::vector<size_t> send_lens;
+
+    /// incoming blocks within the segments of the owners
+    std::vector<int> sources;
+    std::vector<const char*> recv_bases;
+    std::vector<size_t> recv_displs;
+    std::vector<size_t> recv_lens;
+    std::vector<size_t> recv_halves;
+  };
+
+  /// shared-memory segments per mode
+  std::unordered_map<int, Shm_window> _shm_windows;
+
+  /// release a shared segment; collective over the node
+  static void _free_shm_window(Shm_window& w)
+  {
+    if(w.win == MPI_WIN_NULL) return;
+
+    MPI_Win_unlock_all(w.win);
+    MPI_Win_free(&w.win);
+  }
+
+  /*! (Re)build the shared segment of mode if needed.
+   *
+   * NOTE: collective; it happens at the first send_data(mode) after 
+   * analyze_boundaries (which all ranks call together).
+   */
+  Shm_window& _update_shm_window(int mode)
+  {
+    auto it = _shm_windows.find(mode);
+    if(it != _shm_windows.end() && !it->second.stale && it->second.exchange == data_exchange) {
+      return it->second;
+    }
+
+    auto& w = _shm_windows[mode];
+    _free_shm_window(w);
+    w = Shm_window();
+    w.exchange = data_exchange;
+
+    for(auto& elem : send_schedule) {
+      if(!_via_shared(elem.first)) continue;
+
+      auto len = _fixed_message_size(elem.second, mode, elem.first);
+      if(len == 0) throw std::runtime_error("shared-memory exchange needs fixed-size tile payloads");
+
+      w.dests.push_back(elem.first);
+      w.send_displs.push_back(w.half);
+      w.send_lens.push_back(len);
+      w.half += len;
+    }
+
+    MPI_Win_allocate_shared( static_cast<MPI_Aint>(2*w.half), 1, MPI_INFO_NULL, _node_comm, &w.base, &w.win);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, w.win);
+
+    // tell every receiver where its block is
+    std::vector<MPI_Request> reqs(w.dests.size());
+    std::vector<std::array<MPI_Aint,3>> blocks(w.dests.size());
+    for(size_t r=0; r<w.dests.size(); r++) {
+      blocks[r] = {{ 
+        static_cast<MPI_Aint>(w.send_displs[r]), 
+        static_cast<MPI_Aint>(w.send_lens[r]), 
+        static_cast<MPI_Aint>(w.half) }};
+      MPI_Isend(blocks[r].data(), 3, MPI_AINT, w.dests[r], _data_tag(mode), comm, &reqs[r]);
+    }
+
+    for(auto& elem : recv_schedule) {
+      int orig = elem.first;
+      if(!_via_shared(orig)) continue;
+
+      std::array<MPI_Aint,3> block;
+      MPI_Recv(block.data(), 3, MPI_AINT, orig, _data_tag(mode), comm, MPI_STATUS_IGNORE);
+      assert( static_cast<size_t>(block[1]) == _fixed_message_size(elem.second, mode, comm.rank()) );
+
+      MPI_Aint size;
+      int disp_unit;
+      char* ptr = nullptr;
+      MPI_Win_shared_query(w.win, _node_ranks[orig], &size, &disp_unit, &ptr);
+
+      w.sources.push_back(orig);
+      w.recv_bases.push_back(ptr);
+      w.recv_displs.push_back( static_cast<size_t>(block[0]) );
+      w.recv_lens.push_back(   static_cast<size_t>(block[1]) );
+      w.recv_halves.push_back( static_cast<size_t>(block[2]) );
+    }
+    MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE);
+
+    return w;
+  }
+
+  /// pack tiles of same-node receivers straight into my shared segment
+  void _send_shared_data(int mode)
+  {
+    auto& w = _update_shm_window(mode);
+
+    char* half = w.base + w.parity*w.half;
+    for(size_t r=0; r<w.dests.size(); r++) {
+      tools::byte_writer out(half + w.send_displs[r], w.send_lens[r]);
+      for(auto cid : _scheduled(send_schedule, w.dests[r])) _pack_tile_data(get_tile(cid), out, mode, w.dests[r]);
+      assert(out.size() == w.send_lens[r]);
+    }
+  }
+
+  /// wait for the node and unpack directly from the owners' segments
+  void _wait_shared_data(int mode)
+  {
+    auto& w = _shm_windows.at(mode);
+
+    MPI_Win_sync(w.win);
+    MPI_Barrier(_node_comm);
+    MPI_Win_sync(w.win);
+
+    for(size_t r=0; r<w.sources.size(); r++) {
+      const char* in = w.recv_bases[r] + w.parity*w.recv_halves[r] + w.recv_displs[r];
+      _unpack_tile_data(in, w.recv_lens[r], _scheduled(recv_schedule, w.sources[r]), mode);
+    }
+
+    w.parity ^= 1;
+  }
+
+  /// MPI tag of aggregated data messages; kept clear of commType tags
+  static int _data_tag(int mode) { return commType::N_COMMTYPES + mode; }
+
+  /// rebuild send/recv schedule if tile ownership has changed
+  void _update_schedule()
+  {
+    _update_node_comm();
+    _sync_topology();
+
+    if(!_schedule_dirty) return;
+
+    // re-order sends and compute mpi tags
+    send_schedule.clear();
+    for(auto cid : get_boundary_tiles() ) {
+      auto& tile = get_tile(cid);
+
+      // TODO proceed only if tile is active 
+      for(auto dest: tile.virtual_owners) {
+        send_schedule[dest].push_back(cid);
+      }
+    }
+
+    recv_schedule.clear();
+    for(auto cid : get_virtuals() ) {
+      auto& tile = get_tile(cid);
+
+      //TODO: proceed only if tile is active
+      recv_schedule[tile.communication.owner].push_back(cid);
+    }
+
+    // tile lists are sorted so the schedule is already in cid order
+
+    _free_plans();
+
+    _schedule_dirty = false;
+  }
+
+  /// release persistent requests of a plan
+  static void _free_plan(Exchange_plan& plan)
+  {
+    for(auto& req : plan.reqs) {
+      if(req != MPI_REQUEST_NULL) MPI_Request_free(&req);
+    }
+    plan.reqs.clear();
+  }
+
+  /// release all plans; they are rebuilt on next use
+  void _free_plans()
+  {
+    for(auto& elem : _send_plans) _free_plan(elem.second);
+    for(auto& elem : _recv_plans) _free_plan(elem.second);
+    _send_plans.clear();
+    _recv_plans.clear();
+  }
+
+  /*! Call f(n, offset) for every neighbor direction of tile cid that 
+   * is owned by reader, in stencil order.
+   *
+   * These are the halo regions of the tile that the local tiles of 
+   * reader need; both sides of the exchange get the same sequence.
+   */
+  template<typename F>
+  void _for_halo_dirs(uint64_t cid, int reader, F&& f)
+  {
+    static constexpr auto stencil = corgi::ca::moore_stencil<D>();
+
+    auto& nh = get_neighborhood(cid);
+    for(size_t n=0; n<Neighborhood::size; n++) {
+      if(nh.owners[n] == reader) f(stencil[n]);
+    }
+  }
+
+  /// total message size of tiles or 0 if any of them is of variable size
+  size_t _fixed_message_size(const std::vector<uint64_t>& cids, int mode, int reader)
+  {
+    size_t len = 0;
+    for(auto cid : cids) {
+      auto& tile = get_tile(cid);
+
+      size_t n = 0;
+      if(data_exchange == exchangeType::HALO) {
+        bool fixed = true;
+        _for_halo_dirs(cid, reader, [&](const corgi::ca::offset_t<D>& dir) {
+            size_t m = tile.halo_size(mode, dir);
+            if(m == 0) fixed = false;
+            n += m;
+          });
+        if(!fixed) n = 0;
+      } else {
+        n = tile.packed_size(mode);
+      }
+
+      if(n == 0) return 0;
+      len += sizeof(uint64_t) + n;
+    }
+    return len;
+  }
+
+  /// tiles scheduled for rank (none if rank is not in the schedule)
+  static const std::vector<uint64_t>& _scheduled(
+      const std::map<int, std::vector<uint64_t>>& schedule, 
+      int rank)
+  {
+    static const std::vector<uint64_t> none;
+
+    auto it = schedule.find(rank);
+    return it == schedule.end() ? none : it->second;
+  }
+
+  /// build (or get) aggregated send plan of mode
+  Exchange_plan& _send_plan(int mode)
+  {
+    return _get_plan(_send_plans, send_schedule, mode, true);
+  }
+
+  /// build (or get) aggregated recv plan of mode
+  Exchange_plan& _recv_plan(int mode)
+  {
+    return _get_plan(_recv_plans, recv_schedule, mode, false);
+  }
+
+  Exchange_plan& _get_plan(
+      std::unordered_map<int, Exchange_plan>& plans,
+      const std::map<int, std::vector<uint64_t>>& schedule,
+      int mode,
+      bool sending)
+  {
+    auto it = plans.find(mode);
+    if(it != plans.end()) {
+      auto& old = it->second;
+      if(old.exchange  == data_exchange  && 
+         old.transport == data_transport && 
+         old.shared    == shared_memory) return old;
+
+      // exchange/transport type has been switched; start over
+      _free_plan(old);
+      plans.erase(it);
+    }
+
+    auto& plan = plans[mode];
+    plan.exchange  = data_exchange;
+    plan.transport = data_transport;
+    plan.shared    = shared_memory;
+
+    // neighbor collectives address peers in graph order
+    if(data_transport == transportType::NEIGHBOR_COLLECTIVE) {
+      plan.ranks = sending ? _graph_dests : _graph_sources;
+
+      for(auto& elem : schedule) {
+        assert(std::find(plan.ranks.begin(), plan.ranks.end(), elem.first) != plan.ranks.end());
+      }
+
+      // segments of fixed size are laid out once; same-node ranks get none
+      size_t npeers = plan.ranks.size();
+      plan.counts.assign(npeers, 0);
+      plan.displs.assign(npeers, 0);
+      plan.fixed = true;
+
+      int len = 0;
+      for(size_t r=0; r<npeers; r++) {
+        plan.displs[r] = len;
+        if(_via_shared(plan.ranks[r])) continue;
+
+        auto& cids = _scheduled(schedule, plan.ranks[r]);
+        int reader = sending ? plan.ranks[r] : comm.rank();
+        size_t n = _fixed_message_size(cids, mode, reader);
+        if(n == 0 && !cids.empty()) plan.fixed = false;
+
+        plan.counts[r] = static_cast<int>(n);
+        len += plan.counts[r];
+      }
+      if(plan.fixed) plan.packed.resize( static_cast<size_t>(len) ); // recv side keeps it
+      return plan;
+    }
+
+    for(auto& elem : schedule) {
+      if(!_via_shared(elem.first)) plan.ranks.push_back(elem.first);
+    }
+    size_t npeers = plan.ranks.size();
+    plan.bufs.resize(npeers);
+
+    std::vector<size_t> lens(npeers);
+    plan.fixed = true;
+    for(size_t r=0; r<npeers; r++) {
+      int reader = sending ? plan.ranks[r] : comm.rank();
+      lens[r] = _fixed_message_size(schedule.at(plan.ranks[r]), mode, reader);
+      if(lens[r] == 0) plan.fixed = false;
+    }
+
+    if(plan.fixed) {
+      plan.reqs.resize(npeers, MPI_REQUEST_NULL);
+      for(size_t r=0; r<npeers; r++) {
+        plan.bufs[r].resize(lens[r]); // address is fixed from here on
+
+        if(sending) {
+          MPI_Send_init(plan.bufs[r].data(), static_cast<int>(lens[r]), MPI_BYTE, 
+              plan.ranks[r], _data_tag(mode), comm, &plan.reqs[r]);
+        } else {
+          MPI_Recv_init(plan.bufs[r].data(), static_cast<int>(lens[r]), MPI_BYTE, 
+              plan.ranks[r], _data_tag(mode), comm, &plan.reqs[r]);
+        }
+      }
+    }
+    return plan;
+  }
+
+  /// write tile data going to dest as a chunk prefixed by its length
+  void _pack_tile_data(Tile_t& tile, tools::byte_writer& out, int mode, int dest)
+  {
+    size_t head = out.size();
+    out.put<uint64_t>(0);
+
+    if(data_exchange == exchangeType::HALO) {
+      _for_halo_dirs(tile.cid, dest, [&](const corgi::ca::offset_t<D>& dir) {
+          tile.pack_halo(out, mode, dir);
+        });
+    } else {
+      tile.pack_data(out, mode);
+    }
+
+    uint64_t len = out.size() - head - sizeof(uint64_t);
+    std::memcpy(out.data() + head, &len, sizeof(uint64_t));
+  }
+
+  /// append tile data going to dest as a chunk prefixed by its length
+  void _pack_tile_data(Tile_t& tile, std::vector<char>& bytes, int mode, int dest)
+  {
+    tools::byte_writer out(bytes);
+    _pack_tile_data(tile, out, mode, dest);
+  }
+
+  /// scatter a received aggregated message into the virtual tiles
+  void _unpack_tile_data(
+      const char* bytes, 
+      size_t len, 
+      const std::vector<uint64_t>& cids, 
+      int mode)
+  {
+    tools::byte_reader in(bytes, len);
+    for(auto cid : cids) {
+      auto n = in.get<uint64_t>();
+      auto chunk = in.take( static_cast<size_t>(n) );
+      auto& tile = get_tile(cid);
+
+      if(data_exchange == exchangeType::HALO) {
+        _for_halo_dirs(cid, comm.rank(), [&](const corgi::ca::offset_t<D>& dir) {
+            tile.unpack_halo(chunk, mode, dir);
+          });
+        assert(chunk.empty());
+      } else {
+        tile.unpack_data(chunk, mode);
+      }
+    }
+    assert(in.empty());
+  }
+
+  /// pack and send one message per rank
+  void _send_aggregated_data(int mode)
+  {
+    auto& plan = _send_plan(mode);
+
+    for(size_t r=0; r<plan.ranks.size(); r++) {
+      auto& bytes = plan.bufs[r];
+      auto len = bytes.size();
+
+      // refill in place; capacity (and hence address) stays the same
+      bytes.clear();
+      for(auto cid : send_schedule.at(plan.ranks[r])) _pack_tile_data(get_tile(cid), bytes, mode, plan.ranks[r]);
+
+      if(plan.fixed) {
+        assert(bytes.size() == len);
+        continue;
+      }
+
+      sent_data_messages.at(mode).push_back( 
+          comm.isend(plan.ranks[r], 
+            _data_tag(mode), 
+            bytes.data(), 
+            static_cast<int>(bytes.size()) ) 
+          );
+    }
+
+    if(plan.fixed && !plan.reqs.empty()) {
+      MPI_Startall(static_cast<int>(plan.reqs.size()), plan.reqs.data());
+    }
+  }
+
+  /// pack everything into one buffer and start the neighbor collective
+  //
+  // If every rank knows its message sizes in advance the segments laid out 
+  // in the plans are used as such; otherwise the sizes are exchanged first 
+  // with a MPI_Neighbor_alltoall. The data then moves in one 
+  // MPI_Ineighbor_alltoallv.
+  void _send_neighbor_data(int mode)
+  {
+    _update_graph();
+
+    auto& splan = _send_plan(mode);
+    auto& rplan = _recv_plan(mode);
+    size_t ndests = splan.ranks.size();
+    size_t nsrcs  = rplan.ranks.size();
+
+    bool fixed = _neighbor_sizes_fixed(mode, splan.fixed && rplan.fixed);
+
+    splan.packed.clear();
+    for(size_t r=0; r<ndests; r++) {
+      int dest = splan.ranks[r];
+      int displ = static_cast<int>(splan.packed.size());
+      if(!_via_shared(dest)) {
+        for(auto cid : _scheduled(send_schedule, dest)) _pack_tile_data(get_tile(cid), splan.packed, mode, dest);
+      }
+
+      if(fixed) {
+        assert(splan.displs[r] == displ);
+        assert(static_cast<int>(splan.packed.size()) - displ == splan.counts[r]);
+        continue;
+      }
+      splan.displs[r] = displ;
+      splan.counts[r] = static_cast<int>(splan.packed.size()) - displ;
+    }
+
+    if(!fixed) {
+      rplan.counts.assign(nsrcs, 0);
+      rplan.displs.assign(nsrcs, 0);
+      MPI_Neighbor_alltoall(
+          splan.counts.data(), 1, MPI_INT, 
+          rplan.counts.data(), 1, MPI_INT, 
+          _graph_comm);
+
+      int len = 0;
+      for(size_t r=0; r<nsrcs; r++) {
+        rplan.displs[r] = len;
+        len += rplan.counts[r];
+      }
+      rplan.packed.resize( static_cast<size_t>(len) );
+    }
+
+    splan.reqs.assign(1, MPI_REQUEST_NULL);
+    MPI_Ineighbor_alltoallv(
+        splan.packed.data(), splan.counts.data(), splan.displs.data(), MPI_BYTE,
+        rplan.packed.data(), rplan.counts.data(), rplan.displs.data(), MPI_BYTE,
+        _graph_comm, 
+        &splan.reqs[0]);
+  }
+
+  /// fixed-size agreement of neighbor messages per (mode, exchangeType)
+  std::map<std::pair<int,int>, bool> _neighbor_fixed;
+
+  /*! Do all ranks know their neighbor message sizes of mode in advance.
+   *
+   * NOTE: collective over all ranks; the answer is agreed once per 
+   * graph and exchange type (and again after invalidate_schedule).
+   */
+  bool _neighbor_sizes_fixed(int mode, bool mine)
+  {
+    auto key = std::make_pair(mode, data_exchange);
+    auto it = _neighbor_fixed.find(key);
+    if(it != _neighbor_fixed.end()) {
+      assert(!it->second || mine); // sizes changed; see invalidate_schedule
+      return it->second;
+    }
+
+    int fixed = mine ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &fixed, 1, MPI_INT, MPI_LAND, comm);
+
+    _neighbor_fixed[key] = fixed != 0;
+    return fixed != 0;
+  }
+
+  /// open PSCW epochs and put packed tiles straight into the target windows
+  void _send_rma_data(int mode)
+  {
+    auto& w = _update_window(mode);
+
+    // my virtual tiles are only read back in wait_data
+    MPI_Win_post(w.exposure, 0, w.win);
+
+    for(size_t r=0; r<w.dests.size(); r++) {
+      auto& bytes = w.send_bufs[r];
+
+      bytes.clear();
+      for(auto cid : _scheduled(send_schedule, w.dests[r])) _pack_tile_data(get_tile(cid), bytes, mode, w.dests[r]);
+      assert(bytes.size() == w.send_lens[r]);
+    }
+
+    MPI_Win_start(w.access, 0, w.win);
+    for(size_t r=0; r<w.dests.size(); r++) {
+      int len = static_cast<int>(w.send_bufs[r].size());
+      MPI_Put(w.send_bufs[r].data(), len, MPI_BYTE, 
+          w.dests[r], w.target_displs[r], len, MPI_BYTE, 
+          w.win);
+    }
+  }
+
+  /// close the epochs and scatter window segments into virtual tiles
+  void _wait_rma_data(int mode)
+  {
+    auto& w = _windows.at(mode);
+
+    MPI_Win_complete(w.win);
+    MPI_Win_wait(w.win);
+
+    for(size_t r=0; r<w.sources.size(); r++) {
+      _unpack_tile_data(w.recv.data() + w.recv_displs[r], 
+          static_cast<size_t>(w.recv_lens[r]), 
+          _scheduled(recv_schedule, w.sources[r]), 
+          mode);
+    }
+  }
+
+  /// complete the neighbor collective and scatter data into virtual tiles
+  void _wait_neighbor_data(int mode)
+  {
+    auto& splan = _send_plan(mode);
+    auto& rplan = _recv_plan(mode);
+    assert(splan.reqs.size() == 1);
+
+    MPI_Wait(&splan.reqs[0], MPI_STATUS_IGNORE);
+
+    for(size_t r=0; r<rplan.ranks.size(); r++) {
+      if(_via_shared(rplan.ranks[r])) continue;
+
+      _unpack_tile_data(rplan.packed.data() + rplan.displs[r], 
+          static_cast<size_t>(rplan.counts[r]), 
+          _scheduled(recv_schedule, rplan.ranks[r]), 
+          mode);
+    }
+  }
+
+  /// receive aggregated messages of mode and scatter them into virtual tiles
+  //
+  // Persistent receives are completed with MPI_Waitsome; otherwise ranks 
+  // are polled with MPI_Improbe so that messages are unpacked in the order 
+  // in which they arrive and if none is ready we block on the first one.
+  void _recv_aggregated_data(int mode)
+  {
+    auto& plan = _recv_plan(mode);
+    size_t nmsgs = plan.ranks.size();
+
+    if(plan.fixed) {
+      std::vector<int> completed(nmsgs);
+      size_t nleft = nmsgs;
+      while(nleft > 0) {
+        int ndone = 0;
+        MPI_Waitsome(static_cast<int>(nmsgs), 
+            plan.reqs.data(), 
+            &ndone, 
+            completed.data(), 
+            MPI_STATUSES_IGNORE);
+
+        for(int k=0; k<ndone; k++) {
+          size_t r = static_cast<size_t>(completed[k]);
+          _unpack_tile_data(plan.bufs[r].data(), plan.bufs[r].size(), 
+              recv_schedule.at(plan.ranks[r]), mode);
+        }
+        nleft -= static_cast<size_t>(ndone);
+      }
+      return;
+    }
+
+    std::vector<size_t> pending(nmsgs);
+    for(size_t r=0; r<nmsgs; r++) pending[r] = r;
+
+    MPI_Message msg;
+    MPI_Status status;
+
+    auto unpack = [&](size_t r) {
+      int count = 0;
+      MPI_Get_count(&status, MPI_BYTE, &count);
+
+      auto& bytes = plan.bufs[r];
+      bytes.resize( static_cast<size_t>(count) );
+      MPI_Mrecv(bytes.data(), count, MPI_BYTE, &msg, MPI_STATUS_IGNORE);
+
+      _unpack_tile_data(bytes.data(), bytes.size(), recv_schedule.at(plan.ranks[r]), mode);
+    };
+
+    while(!pending.empty()) {
+      size_t nleft = pending.size();
+
+      for(size_t k=0; k<pending.size(); ) {
+        int flag = 0;
+        MPI_Improbe(plan.ranks[pending[k]], _data_tag(mode), comm, &flag, &msg, &status);
+        if(!flag) { k++; continue; }
+
+        unpack(pending[k]);
+        pending.erase(pending.begin() + static_cast<std::ptrdiff_t>(k));
+      }
+
+      // nothing has arrived yet; wait for the first one
+      if(pending.size() == nleft) {
+        MPI_Mprobe(plan.ranks[pending[0]], _data_tag(mode), comm, &msg, &status);
+        unpack(pending[0]);
+        pending.erase(pending.begin());
+      }
+    }
+  }
+
 
 }; // end of Grid class
 
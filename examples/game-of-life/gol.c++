@@ -1,4 +1,5 @@
 #include <string>
+#include <array>
 
 #include "gol.h"
 #include "../../toolbox/dataContainer.h"
@@ -58,15 +59,19 @@ Mesh& Tile::get_new_data() {
 void Tile::update_boundaries(corgi::Grid<2>& grid) 
 {
   int ito=0, jto=0, ifro=0, jfro=0;
-  Tileptr tpr;
+  Tile_t* tpr;
 
   Mesh& mesh = get_data(); // target as a reference to update into
 
-  for(int in=-1; in <= 1; in++) {
-    for(int jn=-1; jn <= 1; jn++) {
+  // cached neighbors; same (i fastest) order as moore_stencil
+  auto& nh = grid.get_neighborhood(cid);
+  size_t n = 0;
+
+  for(int jn=-1; jn <= 1; jn++) {
+    for(int in=-1; in <= 1; in++) {
       if (in == 0 && jn == 0) continue;
 
-      tpr = std::dynamic_pointer_cast<Tile_t>(grid.get_tileptr( neighs(in, jn) ));
+      tpr = dynamic_cast<Tile_t*>( nh.tiles[n++] );
       if (tpr) {
         Mesh& mpr = tpr->get_data();
 
@@ -125,6 +130,74 @@ std::vector<mpi4cpp::mpi::request> Tile::recv_data(
   return reqs;
 }
 
+void Tile::pack_data( 
+    corgi::tools::byte_writer& buf,
+    int /*mode*/)
+{
+  Mesh& mesh = get_data(); 
+  buf.put(mesh.mesh.data(), mesh.mesh.size());
+}
+
+void Tile::unpack_data( 
+    corgi::tools::byte_reader& buf,
+    int /*mode*/)
+{
+  Mesh& mesh = get_data(); 
+  assert(buf.remaining() == mesh.mesh.size()*sizeof(int));
+  buf.get(mesh.mesh.data(), mesh.mesh.size());
+}
+
+size_t Tile::packed_size(int /*mode*/)
+{
+  return get_data().mesh.size()*sizeof(int);
+}
+
+
+/// interior cells [i0,i1) x [j0,j1) next to the neighbor at dir
+static std::array<int,4> halo_strip(const Mesh& mesh, const corgi::ca::offset_t<2>& dir)
+{
+  int i0 = dir[0] > 0 ? mesh.Nx - mesh.halo : 0;
+  int i1 = dir[0] < 0 ? mesh.halo : mesh.Nx;
+  int j0 = dir[1] > 0 ? mesh.Ny - mesh.halo : 0;
+  int j1 = dir[1] < 0 ? mesh.halo : mesh.Ny;
+
+  return {{i0, i1, j0, j1}};
+}
+
+void Tile::pack_halo( 
+    corgi::tools::byte_writer& buf,
+    int /*mode*/,
+    const corgi::ca::offset_t<2>& dir)
+{
+  Mesh& mesh = get_data(); 
+  auto r = halo_strip(mesh, dir);
+
+  for(int j=r[2]; j<r[3]; j++) {
+    buf.put(&mesh(r[0], j), static_cast<size_t>(r[1] - r[0]));
+  }
+}
+
+void Tile::unpack_halo( 
+    corgi::tools::byte_reader& buf,
+    int /*mode*/,
+    const corgi::ca::offset_t<2>& dir)
+{
+  Mesh& mesh = get_data(); 
+  auto r = halo_strip(mesh, dir);
+
+  for(int j=r[2]; j<r[3]; j++) {
+    buf.get(&mesh(r[0], j), static_cast<size_t>(r[1] - r[0]));
+  }
+}
+
+size_t Tile::halo_size(
+    int /*mode*/,
+    const corgi::ca::offset_t<2>& dir)
+{
+  auto r = halo_strip(get_data(), dir);
+  return static_cast<size_t>( (r[1] - r[0])*(r[3] - r[2]) )*sizeof(int);
+}
+
 
 void Solver::solve(Tile& tile) {
   Mesh& m    = tile.get_data();
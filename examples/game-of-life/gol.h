@@ -119,6 +119,18 @@ class Tile : public corgi::Tile<2> {
     std::vector<mpi4cpp::mpi::request> 
     recv_data( mpi4cpp::mpi::communicator&, int dest, int mode, int tag) override;
 
+    void pack_data(corgi::tools::byte_writer&, int mode) override;
+
+    void unpack_data(corgi::tools::byte_reader&, int mode) override;
+
+    size_t packed_size(int mode) override;
+
+    void pack_halo(corgi::tools::byte_writer&, int mode, const corgi::ca::offset_t<2>& dir) override;
+
+    void unpack_halo(corgi::tools::byte_reader&, int mode, const corgi::ca::offset_t<2>& dir) override;
+
+    size_t halo_size(int mode, const corgi::ca::offset_t<2>& dir) override;
+
 };
 
 
@@ -27,25 +27,6 @@ from simulation import randomInitialize
 np.random.seed(0)
 
 
-# make all tiles same type 
-def initialize_virtuals(n, conf):
-
-    for cid in n.get_virtual_tiles():
-        c_orig = n.get_tile(cid)
-        (i,j) = c_orig.index
-
-        # new CA tile;
-        # TODO: load_metainfo *HAS* to be after add_tile
-        c = pyca.Tile()
-        n.add_tile(c, (i,j)) 
-        c_orig.communication.local = False;
-        c.load_metainfo(c_orig.communication)
-        print("{}: loading {} owned by {}".format(n.rank(), cid, c.communication.owner))
-
-        mesh = pyca.Mesh( conf["NxMesh"], conf["NyMesh"] )
-        c.add_data(mesh)
-        c.add_data(mesh)
-
 
 
 ##################################################
@@ -93,11 +74,16 @@ if __name__ == "__main__":
     
     sol = pyca.Solver()
     
+    # incoming virtual tiles are built directly as correct tile types
+    pyca.set_tile_factory(grid, conf["NxMesh"], conf["NyMesh"])
+
+    # one message per neighbor rank carrying only the halo strips
+    grid.data_exchange = pycorgi.HALO
+
     #static setup; communicate neighbor info once
     grid.analyze_boundaries()
     grid.send_tiles()
     grid.recv_tiles()
-    initialize_virtuals(grid, conf)
 
     plotNode(axs[0], grid, conf)
     saveVisz(0, grid, conf)
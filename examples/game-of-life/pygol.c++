@@ -70,6 +70,26 @@ PYBIND11_MODULE(pyca, m) {
     .def(py::init<>())
     .def("solve", &gol::Solver::solve);
 
+
+  // --------------------------------------------------
+  // Make grid build incoming virtual tiles directly as gol::Tiles
+  m.def("set_tile_factory", [](corgi::Grid<2>& grid, int nx, int ny) 
+      {
+        grid.set_tile_factory(
+          [nx, ny](corgi::Grid<2>& g, const corgi::Communication& /*cm*/) 
+          {
+            auto tile = g.make_tile<gol::Tile>();
+
+            // recycled tiles already have their meshes
+            if(tile->data.size() == 0) {
+              gol::Mesh mesh(nx, ny);
+              tile->add_data(mesh);
+              tile->add_data(mesh);
+            }
+            return tile;
+          });
+      });
+
 }
 
 
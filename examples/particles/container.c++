@@ -208,49 +208,27 @@ void ParticleBlock::transfer_and_wrap_particles(
 void ParticleBlock::pack_outgoing_particles()
 {
   outgoing_particles.clear();
-  outgoing_extra_particles.clear();
     
   // +1 for info particle
   int np = to_other_tiles.size() + 1;
   InfoParticle infoprtcl(np);
 
-  //if (np>1) {
-  //  std::cout << "Packing Np:" << np 
-  //    << " and extra is: " << np-optimal_message_size << "\n";
-  //}
-
-  outgoing_particles.reserve(optimal_message_size);
-  if (np-optimal_message_size > 0) {
-    std::cout << "EXTRA send with " << np-optimal_message_size << "\n";
-    outgoing_extra_particles.reserve( np-optimal_message_size);
-  }
+  outgoing_particles.reserve(np);
 
   // first particle is always the message info
   outgoing_particles.push_back(infoprtcl);
 
   // next, pack all other particles
-  int i=1, ind;
+  int ind;
   for (auto&& elem : to_other_tiles) {
     ind = elem.second;
 
-    if(i < optimal_message_size) {
-      outgoing_particles.emplace_back( 
-        loc(0, ind), loc(1, ind), loc(2, ind), 
-        vel(0, ind), vel(1, ind), vel(2, ind), 
-        wgt(ind));
-    } else {
-      outgoing_extra_particles.emplace_back( 
-        loc(0, ind), loc(1, ind), loc(2, ind), 
-        vel(0, ind), vel(1, ind), vel(2, ind), 
-        wgt(ind));
-    }
-
-    i++;
+    outgoing_particles.emplace_back( 
+      loc(0, ind), loc(1, ind), loc(2, ind), 
+      vel(0, ind), vel(1, ind), vel(2, ind), 
+      wgt(ind));
   }
 
-  // TODO: set next message size dynamically according to history
-  //optimal_message_size = np;
-
   }
 
 
@@ -261,21 +239,10 @@ void ParticleBlock::unpack_incoming_particles()
   // get real number of incoming particles
   InfoParticle msginfo(incoming_particles[0]);
   int number_of_incoming_particles = msginfo.size();
-
-  int number_of_primary_particles = 
-    number_of_incoming_particles > optimal_message_size 
-    ? optimal_message_size : number_of_incoming_particles;
-
-  int number_of_secondary_particles = incoming_extra_particles.size();
-
-  //if (number_of_incoming_particles > 1) {
-  //  std::cout << "unpacking Np:" << number_of_incoming_particles
-  //    << " /+ " << number_of_primary_particles << "/"
-  //    << number_of_secondary_particles << "\n";
-  //}
+  assert(number_of_incoming_particles == (int)incoming_particles.size());
 
   // skipping 1st info particle
-  for(int i=1; i<number_of_primary_particles; i++){
+  for(int i=1; i<number_of_incoming_particles; i++){
     locx = incoming_particles[i].x();
     locy = incoming_particles[i].y();
     locz = incoming_particles[i].z();
@@ -288,19 +255,6 @@ void ParticleBlock::unpack_incoming_particles()
     add_particle({locx,locy,locz}, {velx,vely,velz}, wgt);
   }
 
-  for(int i=0; i<number_of_secondary_particles; i++){
-    locx = incoming_extra_particles[i].x();
-    locy = incoming_extra_particles[i].y();
-    locz = incoming_extra_particles[i].z();
-
-    velx = incoming_extra_particles[i].ux();
-    vely = incoming_extra_particles[i].uy();
-    velz = incoming_extra_particles[i].uz();
-    wgt  = incoming_extra_particles[i].wgt();
-
-    add_particle({locx,locy,locz}, {velx,vely,velz}, wgt);
-  }
-
   }
 
 
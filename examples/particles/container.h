@@ -76,21 +76,14 @@ class ParticleBlock
 
   public:
 
-  /// packed outgoing particles
+  /// packed outgoing particles; first one is the message info
   std::vector<Particle> outgoing_particles;
-  std::vector<Particle> outgoing_extra_particles;
   void pack_outgoing_particles();
 
-  /// packed incoming particles
+  /// packed incoming particles; received with their exact size
   std::vector<Particle> incoming_particles;
-  std::vector<Particle> incoming_extra_particles;
   void unpack_incoming_particles();
 
-  /// dynamic message size that traces the optimal
-  // message length (i.e., number of particles) hand 
-  // in hand with the corresponding receiver side.
-  int optimal_message_size = 10;
-
   //--------------------------------------------------
 
   //! multimap of particles going to other tiles
@@ -350,24 +350,6 @@ def filler(xloc, ispcs, conf):
 
 
 
-# make all tiles same type 
-def initialize_virtuals(n, conf):
-
-    for cid in n.get_virtual_tiles():
-        c_orig = n.get_tile(cid)
-        (i,j) = c_orig.index
-
-        # new prtcl tile;
-        # TODO: load_metainfo *HAS* to be after add_tile
-        c = pyprtcls.Tile()
-        n.add_tile(c, (i,j)) 
-
-        c_orig.communication.local = False;
-        c.load_metainfo(c_orig.communication)
-        print("{}: loading {} owned by {}".format(n.rank(), cid, c.communication.owner))
-        
-        initialize_tile(c, i,j,n, conf)
-
 
 class Conf:
 
@@ -382,6 +364,10 @@ class Conf:
     Nspecies = 2
     ppc = 1
 
+    # move particles with pyprtcls.route_particles instead of 
+    # the neighbor-by-neighbor exchange
+    route = True
+
     outdir = "out"
 
     def update_bbox(self):
@@ -435,11 +421,16 @@ if __name__ == "__main__":
     
     pusher = pyprtcls.Pusher()
     
+    # incoming virtual tiles are built directly as correct tile types
+    pyprtcls.set_tile_factory(grid, conf.Nspecies, conf.NxMesh, conf.NyMesh, conf.NzMesh, conf.ppc)
+
+    # one variable-length message per neighbor rank
+    grid.data_exchange = pycorgi.AGGREGATED
+
     #static setup; communicate neighbor info once
     grid.analyze_boundaries()
     grid.send_tiles()
     grid.recv_tiles()
-    initialize_virtuals(grid, conf)
 
     #plotNode(axs[0], grid, conf)
     plotMesh(axs[0], grid, conf)
@@ -462,6 +453,11 @@ if __name__ == "__main__":
         ################################################## 
         # communication
 
+        # particles can jump over several tiles; one sparse exchange
+        if conf.route:
+            pyprtcls.route_particles(grid, lap)
+            continue
+
         #local particle exchange (independent)
         for cid in grid.get_local_tiles():
             tile = grid.get_tile(cid)
@@ -472,16 +468,10 @@ if __name__ == "__main__":
             tile = grid.get_tile(cid)
             tile.pack_outgoing_particles()
 
-        # MPI global exchange
-        # transfer primary and extra data
+        # MPI global exchange; messages are sized exactly so one round is enough
         grid.send_data(0) #(indepdendent)
-        grid.send_data(1) #(indepdendent)
-
         grid.recv_data(0) #(indepdendent)
-        grid.recv_data(1) #(indepdendent)
-
         grid.wait_data(0) #(indepdendent)
-        grid.wait_data(1) #(indepdendent)
 
 
         # global unpacking (independent)
@@ -1,9 +1,12 @@
 #include <string>
 #include <array>
 #include <cmath>
+#include <map>
 
 #include "prtcls.h"
 #include "container.h"
+#include "wrap.h"
+#include "../../toolbox/sparse_exchange.h"
 
 
 using namespace prtcls;
@@ -74,17 +77,8 @@ int get_tag(int tag, int extra_param)
   return tag + (9+extra_param)*pow(2,16);
 }
 
-// create MPI tag for extra communication given tile 
-// id and extra layer of differentiation
-int get_extra_tag(int tag, int extra_param)
-{
-  assert(extra_param <= 8); // max 8 species
-  assert(tag < (pow(2,16) - 1)); // cray-mpich supports maximum of 2^22-1 tag value
-
-  return tag + (9+8+extra_param)*pow(2,16);
-}
-
-
+// NOTE: mode 1 used to carry the overflow of the fixed-size mode 0 
+// messages; messages are now sized exactly so it is a no-op.
 std::vector<mpi4cpp::mpi::request> Tile::send_data( 
     mpi4cpp::mpi::communicator& comm, 
     int dest, 
@@ -94,7 +88,7 @@ std::vector<mpi4cpp::mpi::request> Tile::send_data(
   if (mode == 0) {
       return Tile::send_particle_data(comm, dest, tag);
   } else if(mode == 1) {
-      return Tile::send_particle_extra_data(comm,dest, tag);
+      return {};
   } else {
       assert(false);
       exit(1);
@@ -121,100 +115,96 @@ std::vector<mpi4cpp::mpi::request> Tile::send_particle_data(
 }
 
 
-std::vector<mpi4cpp::mpi::request> Tile::send_particle_extra_data( 
-    mpi4cpp::mpi::communicator& comm, 
-    int dest,
-    int tag)
+std::vector<mpi4cpp::mpi::request> Tile::recv_data( 
+    mpi4cpp::mpi::communicator& /*comm*/, 
+    int /*orig*/, 
+    int mode,
+    int /*tag*/)
 {
-  std::vector<mpi4cpp::mpi::request> reqs;
-  for(size_t ispc=0; ispc<Nspecies(); ispc++) {
-    ParticleBlock& container = get_container(ispc);
-
-    if(!container.outgoing_extra_particles.empty()) {
-      reqs.push_back(
-          comm.isend(dest, get_extra_tag(tag, ispc), 
-            container.outgoing_extra_particles.data(), 
-            container.outgoing_extra_particles.size())
-          );
-    }
+  // particle messages are received in wait_data when their size is known
+  if(mode == 0 || mode == 1) {
+      return {};
+  } else { 
+      assert(false);
+      exit(1);
   }
-  return reqs;
 }
 
 
-std::vector<mpi4cpp::mpi::request> Tile::recv_data( 
+void Tile::wait_data( 
     mpi4cpp::mpi::communicator& comm, 
     int orig, 
     int mode,
     int tag)
 {
-  if(mode == 0) {
-      return Tile::recv_particle_data(comm,orig,tag);
-  } else if(mode == 1) {
-      return Tile::recv_particle_extra_data(comm,orig,tag);
-  } else { 
-      assert(false);
-      exit(1);
-  }
+  if(mode == 0) Tile::wait_particle_data(comm, orig, tag);
 }
 
 
-std::vector<mpi4cpp::mpi::request> Tile::recv_particle_data( 
+// Incoming message is matched first with MPI_Mprobe so that the receive 
+// buffer can be sized exactly. This is only called from wait_data: 
+// every rank posts its sends in send_data without waiting on receives 
+// so the blocking probe can not deadlock.
+void Tile::wait_particle_data( 
     mpi4cpp::mpi::communicator& comm, 
     int orig,
     int tag)
 {
-  std::vector<mpi4cpp::mpi::request> reqs;
+  if(particle_type == MPI_DATATYPE_NULL) {
+    particle_type = mpi4cpp::mpi::get_mpi_datatype<Particle>( Particle() );
+  }
+
+  MPI_Message msg;
+  MPI_Status status;
+  int count = 0;
+
   for (size_t ispc=0; ispc<Nspecies(); ispc++) {
     ParticleBlock& container = get_container(ispc);
-    container.incoming_particles.resize( container.optimal_message_size );
 
-    reqs.push_back(
-        comm.irecv(orig, get_tag(tag, ispc),
-          container.incoming_particles.data(),
-          container.optimal_message_size)
-        );
-  }
+    MPI_Mprobe(orig, get_tag(tag, ispc), comm, &msg, &status);
+    MPI_Get_count(&status, particle_type, &count);
 
-  return reqs;
+    container.incoming_particles.resize(count);
+    MPI_Mrecv(container.incoming_particles.data(), count, particle_type, &msg, MPI_STATUS_IGNORE);
+  }
 }
 
 
-std::vector<mpi4cpp::mpi::request> Tile::recv_particle_extra_data( 
-    mpi4cpp::mpi::communicator& comm, 
-    int orig,
-    int tag)
+Tile::~Tile()
 {
-  std::vector<mpi4cpp::mpi::request> reqs;
+  int finalized = 0;
+  MPI_Finalized(&finalized);
+  if(particle_type != MPI_DATATYPE_NULL && !finalized) MPI_Type_free(&particle_type);
+}
 
-  // this assumes that wait for the first message is already called
-  // and passed.
 
-  int extra_size;
-  for (size_t ispc=0; ispc<Nspecies(); ispc++) {
-    ParticleBlock& container = get_container(ispc);
-    InfoParticle msginfo(container.incoming_particles[0]);
-
-    // check if we need to expect extra message
-    extra_size = msginfo.size() - container.optimal_message_size;
-    if(extra_size > 0) {
-      container.incoming_extra_particles.resize(extra_size);
-
-      reqs.push_back(
-          comm.irecv(orig, get_extra_tag(tag, ispc),
-            container.incoming_extra_particles.data(),
-            extra_size)
-          );
-    } else {
-      container.incoming_extra_particles.clear();
-    }
+void Tile::pack_data(
+    corgi::tools::byte_writer& buf,
+    int mode)
+{
+  if(mode != 0) return;
 
-    //TODO: dynamic optimal_message_size here
-    //container.optimal_message_size = msginfo.size();
+  for(size_t ispc=0; ispc<Nspecies(); ispc++) {
+    auto& prtcls = get_container(ispc).outgoing_particles;
 
+    buf.put_varint(prtcls.size());
+    buf.put(prtcls.data(), prtcls.size());
   }
+}
 
-  return reqs;
+
+void Tile::unpack_data(
+    corgi::tools::byte_reader& buf,
+    int mode)
+{
+  if(mode != 0) return;
+
+  for(size_t ispc=0; ispc<Nspecies(); ispc++) {
+    auto& prtcls = get_container(ispc).incoming_particles;
+
+    prtcls.resize( buf.get_varint() );
+    buf.get(prtcls.data(), prtcls.size());
+  }
 }
 
 
@@ -242,6 +232,115 @@ void Tile::delete_all_particles()
 }
 
 
+// Particles are looked up by coordinate so that they can land any 
+// number of tiles away; local destinations are filled directly and 
+// remote ones are sent as (cid, species, particle) records with a 
+// single sparse exchange round. No neighbor-by-neighbor forwarding 
+// is needed since the final owner is known up front.
+void prtcls::route_particles(corgi::Grid<2>& grid, int round)
+{
+  // NBX rounds alternate between two tags; see sparse_exchange
+  const int tag = 8*(1<<16) + (round % 2);
+
+  const int myrank = grid.comm.rank();
+
+  // owners far from my tiles are needed; see adoption_council_distributed
+  if(grid.owners_partial()) grid.allgather_mpi_grid();
+
+  // only the grid dimensions are periodic; z is left as it is
+  std::array<double,2> grid_mins = {
+    static_cast<double>( grid.get_xmin() ),
+    static_cast<double>( grid.get_ymin() )
+  };
+
+  std::array<double,2> grid_maxs = {
+    static_cast<double>( grid.get_xmax() ),
+    static_cast<double>( grid.get_ymax() )
+  };
+
+  std::map<int, std::vector<char>> outgoing;
+
+  for(auto cid : grid.get_local_tiles()) {
+    Tile& tile = dynamic_cast<Tile&>( grid.get_tile(cid) );
+
+    for(size_t ispc=0; ispc<tile.Nspecies(); ispc++) {
+      ParticleBlock& container = tile.get_container(ispc);
+      container.to_other_tiles.clear();
+
+      // NOTE: particles appended below by other tiles are already 
+      // inside their tile and fall through the first check
+      for(size_t n=0; n<container.size(); n++) {
+        std::array<double,2> x = { container.loc(0,n), container.loc(1,n) };
+
+        if( (x[0] >= tile.mins[0]) && (x[0] < tile.maxs[0]) &&
+            (x[1] >= tile.mins[1]) && (x[1] < tile.maxs[1]) ) continue;
+
+        auto ind = grid.tile_index_at(x);
+        uint64_t dest = grid.id(ind);
+
+        // wrapped around the whole grid (or rounding at the tile edge)
+        if(dest == cid) {
+          for(size_t i=0; i<2; i++) 
+            container.loc(i,n) = wrap( container.loc(i,n), grid_mins[i], grid_maxs[i] );
+          continue;
+        }
+
+        // relative offset is only informative; deletion uses the index
+        container.to_other_tiles.insert( std::make_pair( 
+              std::make_tuple( 
+                static_cast<int>(std::get<0>(ind)) - static_cast<int>(std::get<0>(tile.index)),
+                static_cast<int>(std::get<1>(ind)) - static_cast<int>(std::get<1>(tile.index)),
+                0), 
+              n) );
+
+        double data[7] = {
+          wrap( container.loc(0,n), grid_mins[0], grid_maxs[0] ),
+          wrap( container.loc(1,n), grid_mins[1], grid_maxs[1] ),
+          container.loc(2,n),
+          container.vel(0,n), container.vel(1,n), container.vel(2,n),
+          container.wgt(n) };
+
+        int owner = grid.owner_at(x);
+        if(owner == myrank) {
+          Tile& target = dynamic_cast<Tile&>( grid.get_tile(dest) );
+          target.get_container(ispc).add_particle(
+              {data[0], data[1], data[2]}, {data[3], data[4], data[5]}, data[6]);
+        } else {
+          corgi::tools::byte_writer buf(outgoing[owner]);
+          buf.put(dest);
+          buf.put_varint(ispc);
+          buf.put(data, 7);
+        }
+      }
+    }
+  }
+
+  for(auto cid : grid.get_local_tiles()) {
+    Tile& tile = dynamic_cast<Tile&>( grid.get_tile(cid) );
+    tile.delete_transferred_particles();
+  }
+
+  corgi::tools::sparse_exchange(grid.comm, tag, outgoing, 
+      [&](int /*orig*/, const std::vector<char>& bytes) 
+      {
+        corgi::tools::byte_reader buf(bytes.data(), bytes.size());
+        double data[7];
+
+        while(!buf.empty()) {
+          auto dest = buf.get<uint64_t>();
+          auto ispc = buf.get_varint();
+          buf.get(data, 7);
+
+          Tile& target = dynamic_cast<Tile&>( grid.get_tile(dest) );
+          assert(target.communication.owner == myrank);
+
+          target.get_container(ispc).add_particle(
+              {data[0], data[1], data[2]}, {data[3], data[4], data[5]}, data[6]);
+        }
+      });
+}
+
+
 
 void Pusher::solve(Tile& tile) 
 {
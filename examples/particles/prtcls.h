@@ -23,7 +23,10 @@ class Tile : public corgi::Tile<2> {
   using Tileptr = std::shared_ptr<Tile>;
 
   Tile() = default;
-  ~Tile() override = default;
+  ~Tile() override;
+
+  Tile(const Tile&) = delete;
+  Tile& operator=(const Tile&) = delete;
 
   /// particle storage
   std::vector<ParticleBlock> containers;
@@ -35,6 +38,13 @@ class Tile : public corgi::Tile<2> {
   void set_container(const ParticleBlock& block) {containers.push_back(block);};
 
   size_t Nspecies() {return containers.size(); };
+
+  /// empty the particle containers before re-use; allocations are kept
+  void recycle() override
+  {
+    corgi::Tile<2>::recycle();
+    delete_all_particles();
+  }
     
 
 
@@ -47,23 +57,24 @@ class Tile : public corgi::Tile<2> {
   std::vector<mpi4cpp::mpi::request> 
   send_particle_data( mpi4cpp::mpi::communicator& /*comm*/, int dest, int tag);
 
-  /// actual tag=1 send
-  std::vector<mpi4cpp::mpi::request> 
-  send_particle_extra_data( mpi4cpp::mpi::communicator& /*comm*/, int dest, int tag);
-
 
   //--------------------------------------------------
   // MPI recv
   std::vector<mpi4cpp::mpi::request> 
   recv_data(mpi4cpp::mpi::communicator& /*comm*/, int orig, int mode, int tag) override;
 
+  /// finish the receive once the message size is known
+  void wait_data(mpi4cpp::mpi::communicator& /*comm*/, int orig, int mode, int tag) override;
+
   /// actual tag=0 recv
-  std::vector<mpi4cpp::mpi::request> 
-  recv_particle_data(mpi4cpp::mpi::communicator& /*comm*/, int orig, int tag);
+  void wait_particle_data(mpi4cpp::mpi::communicator& /*comm*/, int orig, int tag);
+
 
-  /// actual tag=1 recv
-  std::vector<mpi4cpp::mpi::request> 
-  recv_particle_extra_data(mpi4cpp::mpi::communicator& /*comm*/, int orig, int tag);
+  //--------------------------------------------------
+  // aggregated exchange
+  void pack_data(corgi::tools::byte_writer& /*buf*/, int mode) override;
+
+  void unpack_data(corgi::tools::byte_reader& /*buf*/, int mode) override;
   //--------------------------------------------------
 
 
@@ -87,10 +98,24 @@ class Tile : public corgi::Tile<2> {
   /// delete all particles from each container
   void delete_all_particles();
 
+  private:
+
+  /// committed MPI type of Particle; created on first receive
+  MPI_Datatype particle_type = MPI_DATATYPE_NULL;
+
 };
 
 
 
+/// Move every particle that left its local tile directly into the tile
+// containing it, however far away; remote tiles are reached with a
+// single sparse exchange round. Replaces check/pack/send/transfer/delete.
+// Consecutive calls must pass consecutive round numbers (e.g., the lap).
+// Collective; a partial owner grid is rebuilt first (allgather_mpi_grid).
+void route_particles(corgi::Grid<2>& grid, int round);
+
+
+
 /// Particle mover
 class Pusher {
 
@@ -62,6 +62,37 @@ PYBIND11_MODULE(pyprtcls, m) {
     .def("solve", &prtcls::Pusher::solve);
 
 
+  // round only matters by its parity: consecutive calls alternate the 
+  // message tag so they have to pass consecutive numbers (e.g., the lap)
+  m.def("route_particles", &prtcls::route_particles,
+      py::arg("grid"), py::arg("round"));
+
+
+  // --------------------------------------------------
+  // Make grid build incoming virtual tiles directly as prtcls::Tiles
+  m.def("set_tile_factory", [](corgi::Grid<2>& grid, 
+                               size_t nspecies, 
+                               size_t nx, size_t ny, size_t nz, 
+                               size_t ppc) 
+      {
+        grid.set_tile_factory(
+          [=](corgi::Grid<2>& g, const corgi::Communication& /*cm*/) 
+          {
+            auto tile = g.make_tile<prtcls::Tile>();
+
+            // recycled tiles already have their (emptied) containers
+            if(tile->Nspecies() == 0) {
+              for(size_t sps=0; sps<nspecies; sps++) {
+                prtcls::ParticleBlock container(nx, ny, nz);
+                container.reserve(nx*ny*nz*ppc);
+                tile->set_container(container);
+              }
+            }
+            return tile;
+          });
+      });
+
+
 }
 
 
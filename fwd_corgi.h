@@ -1,13 +1,27 @@
 #pragma once
 
+#include <cstddef>
+
 
 // Simple forward declaration of Grid for bigger projects
 // that might have namespace duplicates.
 namespace corgi {
 
-template<std::size_t D>
-class Grid;
+namespace tools {
+template< typename T, int D>
+class dense_grid;
+}
 
+namespace indexing {
+template<std::size_t D>
+class linear;
 }
 
+template<
+  std::size_t D, 
+  template<typename, int> class Storage = tools::dense_grid,
+  template<std::size_t> class Ordering = indexing::linear
+  >
+class Grid;
 
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+#include <initializer_list>
+
+#include "internals.h"
+
+
+namespace corgi { namespace indexing {
+
+// Tile indexing engines (orderings) that can be given to corgi::Grid 
+// as a policy. Every engine provides
+//  - ctor from the grid dimensions,
+//  - encode(indices) -> cid, and
+//  - decode(cid) -> indices.
+//
+// Tile id lists are sorted by cid so the ordering also dictates the
+// order in which tiles are stored and communicated.
+
+
+/*! \brief Linear tile indexing engine
+ *
+ * Maps D-dimensional tile indices into unique tile IDs (and back)
+ * assuming column-major order, i.e., first index runs fastest.
+ *
+ *  what we compute:
+ *        \f[
+ *            \begin{cases}
+ *            C_i = \prod_{j=0}^{i-1} L_j
+ *            \\
+ *            \text{cid} = \sum_i C_i I_i
+ *            \end{cases}
+ *        \f]
+ *
+ * Coefficients are computed once during construction so that
+ * encoding is a single (compile-time unrolled) inner product and
+ * decoding needs D divisions.
+ */
+template<std::size_t D>
+class linear
+{
+  std::array<size_t, D> _lengths{};
+  std::array<size_t, D> _coeffs{};
+
+  template<size_t... Is>
+  uint64_t _encode(
+      const std::array<size_t, D>& ind,
+      std::index_sequence<Is...> /*unused*/) const noexcept
+  {
+    uint64_t cid = 0;
+    (void)std::initializer_list<int>{
+      ((cid += static_cast<uint64_t>(ind[Is]*_coeffs[Is])), 0)... };
+    return cid;
+  }
+
+  template<size_t... Is>
+  std::array<size_t, D> _decode(
+      uint64_t cid,
+      std::index_sequence<Is...> /*unused*/) const noexcept
+  {
+    return {{ static_cast<size_t>( (cid/_coeffs[Is]) % _lengths[Is] )... }};
+  }
+
+  public:
+
+  linear() = default;
+
+  explicit linear(const std::array<size_t, D>& lengths) :
+    _lengths(lengths)
+  {
+    size_t c = 1;
+    for(size_t i=0; i<D; i++) {
+      _coeffs[i] = c;
+      c *= _lengths[i];
+    }
+  }
+
+  /// grid dimensions that the coefficients are computed for
+  const std::array<size_t, D>& lengths() const noexcept { return _lengths; }
+
+  /// index coefficients
+  const std::array<size_t, D>& coeffs() const noexcept { return _coeffs; }
+
+  /// tile indices -> tile ID
+  uint64_t encode(const std::array<size_t, D>& ind) const noexcept
+  {
+    return _encode(ind, std::make_index_sequence<D>{});
+  }
+
+  /// tile ID -> tile indices
+  std::array<size_t, D> decode(uint64_t cid) const noexcept
+  {
+    return _decode(cid, std::make_index_sequence<D>{});
+  }
+
+};
+
+
+
+/// number of bits needed to represent all indices of the grid
+template<std::size_t D>
+inline size_t bits_per_dimension(const std::array<size_t, D>& lengths)
+{
+  size_t maxlen = *std::max_element(lengths.begin(), lengths.end());
+
+  size_t bits = 1;
+  while( (static_cast<size_t>(1) << bits) < maxlen ) bits++;
+
+  assert(bits*D <= 64); // cid has to fit into uint64_t
+  return bits;
+}
+
+
+/*! \brief Morton Z-order tile indexing engine
+ *
+ * Tile ID is built by interleaving the bits of the tile indices, 
+ * i.e., bit b of index i ends up in bit b*D + i of the ID. Tiles that 
+ * are close in space get close IDs.
+ *
+ * NOTE: for grids with non power-of-two dimensions the IDs are not 
+ * contiguous; they are unique and bounded by 2^(D*bits).
+ */
+template<std::size_t D>
+class morton
+{
+  std::array<size_t, D> _lengths{};
+  size_t _bits = 1;
+
+  public:
+
+  morton() = default;
+
+  explicit morton(const std::array<size_t, D>& lengths) :
+    _lengths(lengths),
+    _bits(bits_per_dimension<D>(lengths))
+  { }
+
+  const std::array<size_t, D>& lengths() const noexcept { return _lengths; }
+
+  /// tile indices -> tile ID
+  uint64_t encode(const std::array<size_t, D>& ind) const noexcept
+  {
+    uint64_t cid = 0;
+    for(size_t b=0; b<_bits; b++) {
+      for(size_t i=0; i<D; i++) {
+        cid |= static_cast<uint64_t>( (ind[i] >> b) & 1 ) << (b*D + i);
+      }
+    }
+    return cid;
+  }
+
+  /// tile ID -> tile indices
+  std::array<size_t, D> decode(uint64_t cid) const noexcept
+  {
+    std::array<size_t, D> ind;
+    ind.fill(0);
+
+    for(size_t b=0; b<_bits; b++) {
+      for(size_t i=0; i<D; i++) {
+        ind[i] |= static_cast<size_t>( (cid >> (b*D + i)) & 1 ) << b;
+      }
+    }
+    return ind;
+  }
+
+};
+
+
+/*! \brief Hilbert curve tile indexing engine
+ *
+ * N-dimensional Hilbert curve following 
+ *  - J. Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707, 381 (2004).
+ *
+ * Consecutive IDs are always face-neighbors so the locality 
+ * is better than with the Morton ordering.
+ *
+ * NOTE: for grids with non power-of-two dimensions the IDs are not 
+ * contiguous; they are unique and bounded by 2^(D*bits).
+ */
+template<std::size_t D>
+class hilbert
+{
+  std::array<size_t, D> _lengths{};
+  size_t _bits = 1;
+
+  public:
+
+  hilbert() = default;
+
+  explicit hilbert(const std::array<size_t, D>& lengths) :
+    _lengths(lengths),
+    _bits(bits_per_dimension<D>(lengths))
+  { }
+
+  const std::array<size_t, D>& lengths() const noexcept { return _lengths; }
+
+  /// tile indices -> tile ID
+  uint64_t encode(const std::array<size_t, D>& ind) const noexcept
+  {
+    std::array<uint64_t, D> x;
+    for(size_t i=0; i<D; i++) x[i] = ind[i];
+
+    const uint64_t M = static_cast<uint64_t>(1) << (_bits-1);
+    uint64_t t;
+
+    // inverse undo
+    for(uint64_t Q = M; Q > 1; Q >>= 1) {
+      uint64_t P = Q - 1;
+      for(size_t i=0; i<D; i++) {
+        if(x[i] & Q) {
+          x[0] ^= P; // invert
+        } else {     // exchange
+          t = (x[0] ^ x[i]) & P;
+          x[0] ^= t;
+          x[i] ^= t;
+        }
+      }
+    }
+
+    // Gray encode
+    for(size_t i=1; i<D; i++) x[i] ^= x[i-1];
+    t = 0;
+    for(uint64_t Q = M; Q > 1; Q >>= 1) {
+      if(x[D-1] & Q) t ^= Q - 1;
+    }
+    for(size_t i=0; i<D; i++) x[i] ^= t;
+
+    // interleave the transposed form into ID; most significant bits first
+    uint64_t cid = 0;
+    for(size_t b=_bits; b-- > 0; ) {
+      for(size_t i=0; i<D; i++) {
+        cid = (cid << 1) | ((x[i] >> b) & 1);
+      }
+    }
+    return cid;
+  }
+
+  /// tile ID -> tile indices
+  std::array<size_t, D> decode(uint64_t cid) const noexcept
+  {
+    // de-interleave ID into the transposed form
+    std::array<uint64_t, D> x;
+    x.fill(0);
+
+    size_t n = _bits*D;
+    for(size_t b=_bits; b-- > 0; ) {
+      for(size_t i=0; i<D; i++) {
+        n--;
+        x[i] |= ((cid >> n) & 1) << b;
+      }
+    }
+
+    const uint64_t N = static_cast<uint64_t>(2) << (_bits-1);
+    uint64_t t;
+
+    // Gray decode by H ^ (H/2)
+    t = x[D-1] >> 1;
+    for(size_t i=D-1; i>0; i--) x[i] ^= x[i-1];
+    x[0] ^= t;
+
+    // undo excess work
+    for(uint64_t Q = 2; Q != N; Q <<= 1) {
+      uint64_t P = Q - 1;
+      for(size_t i=D; i-- > 0; ) {
+        if(x[i] & Q) {
+          x[0] ^= P; // invert
+        } else {     // exchange
+          t = (x[0] ^ x[i]) & P;
+          x[0] ^= t;
+          x[i] ^= t;
+        }
+      }
+    }
+
+    std::array<size_t, D> ind;
+    for(size_t i=0; i<D; i++) ind[i] = static_cast<size_t>(x[i]);
+    return ind;
+  }
+
+};
+
+
+}} // ns corgi::indexing
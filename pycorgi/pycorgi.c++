@@ -35,7 +35,7 @@ auto declare_tile(
               corgi::Tile<D>& t, corgi::Grid<D>& g)
             {
               corgi::internals::tuple_of<D, size_t> ind = 
-                g.id2index( t.cid, g.lens() );
+                g.id2index( t.cid );
 
               return ind;
             })
@@ -48,15 +48,16 @@ auto declare_tile(
 }
 
 
-template<size_t D>
+template<size_t D, template<size_t> class Ordering = corgi::indexing::linear>
 auto declare_node(
     py::module &m, 
     const std::string& pyclass_name) 
 {
+  using Grid_t = corgi::Grid<D, corgi::tools::dense_grid, Ordering>;
 
   
   // standard version with pybind default holder type 
-  //py::class_<corgi::Grid<D> > corgi_node(m, pyclass_name.c_str());
+  //py::class_<Grid_t > corgi_node(m, pyclass_name.c_str());
       
   // Special version that makes grid indestructible from python 
   // (avoids py garbage collection)
@@ -66,63 +67,155 @@ auto declare_node(
   // also prevents multiple simultaneous versions). This *should* make it ok.
   // Without this both c++ grid and python call garbage collection on dangling 
   // tiles. This leads to double freeing of tiles and subsequent seg faulting.
-  py::class_<corgi::Grid<D>,
-      std::unique_ptr<corgi::Grid<D>, py::nodelete>
+  py::class_<Grid_t,
+      std::unique_ptr<Grid_t, py::nodelete>
       > corgi_node(m, pyclass_name.c_str());
 
     corgi_node
-        .def("rank",      [](corgi::Grid<D>& n) { return n.comm.rank(); })
-        .def("size",      [](corgi::Grid<D>& n) { return n.comm.size(); })
-        .def("master",    [](corgi::Grid<D>& n) { return n.comm.rank() == 0; })
+        .def("rank",      [](Grid_t& n) { return n.comm.rank(); })
+        .def("size",      [](Grid_t& n) { return n.comm.size(); })
+        .def("master",    [](Grid_t& n) { return n.comm.rank() == 0; })
         // specialized for dimensions
-        //.def("add_tile",              &corgi::Grid<D>::add_tile, py::keep_alive<1,2>())
-        .def("replace_tile",          &corgi::Grid<D>::replace_tile, py::keep_alive<1,2>())
-        .def("get_tile_ids",           &corgi::Grid<D>::get_tile_ids,
+        //.def("add_tile",              &Grid_t::add_tile, py::keep_alive<1,2>())
+        .def("replace_tile",          &Grid_t::replace_tile, py::keep_alive<1,2>())
+        .def("get_tile_ids",           &Grid_t::get_tile_ids,
                 py::arg("sorted") = true)
         .def("get_tile", 
-            (std::shared_ptr<corgi::Tile<D>> (corgi::Grid<D>::*)(const uint64_t)) 
-              &corgi::Grid<D>::get_tileptr,
+            (std::shared_ptr<corgi::Tile<D>> (Grid_t::*)(const uint64_t)) 
+              &Grid_t::get_tileptr,
               py::return_value_policy::reference,
               py::keep_alive<1,0>()
               )
 
-        .def("get_local_tiles",             &corgi::Grid<D>::get_local_tiles,
+        .def("get_local_tiles",             &Grid_t::get_local_tiles,
                  py::arg("sorted") = true)
-        .def("get_virtual_tiles",          &corgi::Grid<D>::get_virtuals,
+        .def("get_virtual_tiles",          &Grid_t::get_virtuals,
                  py::arg("sorted") = true)
-        .def("get_boundary_tiles",          &corgi::Grid<D>::get_boundary_tiles,
+        .def("get_boundary_tiles",          &Grid_t::get_boundary_tiles,
                  py::arg("sorted") = true)
 
-        .def("is_local",              &corgi::Grid<D>::is_local)
-        .def("analyze_boundaries", &corgi::Grid<D>::analyze_boundaries)
+        .def("is_local",              &Grid_t::is_local)
+        .def("get_neighborhood", [](Grid_t& n, const uint64_t cid) {
+            // cached Moore neighborhood as (cids, owners)
+            auto& nh = n.get_neighborhood(cid);
+            return py::make_tuple(nh.cids, nh.owners);
+          })
+        .def("analyze_boundaries", &Grid_t::analyze_boundaries)
 
         // // communication wrappers
-        .def("send_tile",               &corgi::Grid<D>::send_tile)
-        .def("recv_tile",               &corgi::Grid<D>::recv_tile)
-        .def_readwrite("send_queue",         &corgi::Grid<D>::send_queue)
-        .def_readwrite("send_queue_address", &corgi::Grid<D>::send_queue_address)
-        .def("bcast_mpi_grid",          &corgi::Grid<D>::bcast_mpi_grid)
-        .def("allgather_work_grid",     &corgi::Grid<D>::allgather_work_grid)
-        .def("update_work",             &corgi::Grid<D>::update_work)
-
-        .def("send_tiles",              &corgi::Grid<D>::send_tiles)
-        .def("recv_tiles",              &corgi::Grid<D>::recv_tiles)
-        .def("send_data",               &corgi::Grid<D>::send_data)
-        .def("recv_data",               &corgi::Grid<D>::recv_data)
-        .def("wait_data",               &corgi::Grid<D>::wait_data)
+        .def("send_tile",               &Grid_t::send_tile)
+        .def("recv_tile",               &Grid_t::recv_tile)
+        .def_readwrite("send_queue",         &Grid_t::send_queue)
+        .def_readwrite("send_queue_address", &Grid_t::send_queue_address)
+        .def("bcast_mpi_grid",          &Grid_t::bcast_mpi_grid)
+        .def("allgather_mpi_grid",      &Grid_t::allgather_mpi_grid)
+        .def("owners_partial",          &Grid_t::owners_partial)
+        .def("allgather_work_grid",     &Grid_t::allgather_work_grid)
+        .def("update_work",             &Grid_t::update_work)
+        .def("get_quota",               &Grid_t::get_quota)
+
+        .def("send_tiles",              &Grid_t::send_tiles)
+        .def("recv_tiles",              &Grid_t::recv_tiles)
+        .def("send_data",               &Grid_t::send_data)
+        .def("recv_data",               &Grid_t::recv_data)
+        .def("wait_data",               &Grid_t::wait_data)
+        .def_readwrite("data_exchange", &Grid_t::data_exchange)
+        .def_readwrite("data_transport",&Grid_t::data_transport)
+        .def_readwrite("shared_memory", &Grid_t::shared_memory)
+        .def("invalidate_schedule",     &Grid_t::invalidate_schedule)
 
         // adoption routines
-        .def("adopt",                   &corgi::Grid<D>::adopt)
-        .def("adoption_council",        &corgi::Grid<D>::adoption_council)
-        .def("adoption_council2",       &corgi::Grid<D>::adoption_council2)
-        .def("communicate_adoptions",   &corgi::Grid<D>::communicate_adoptions)
-        .def("erase_virtuals",          &corgi::Grid<D>::erase_virtuals);
+        .def("adopt",                   &Grid_t::adopt)
+        .def("adoption_council",        &Grid_t::adoption_council)
+        .def("adoption_council2",       &Grid_t::adoption_council2)
+        .def("adoption_council_distributed", &Grid_t::adoption_council_distributed)
+        .def("communicate_adoptions",   &Grid_t::communicate_adoptions)
+        .def("erase_virtuals",          &Grid_t::erase_virtuals)
+        .def("erase_stale_virtuals",    &Grid_t::erase_stale_virtuals);
+
+
+  return corgi_node;
+}
+
+
+
+
+/// one size_t argument per dimension
+template<size_t>
+using size_arg = size_t;
 
 
+/// Index-based grid API for grids with a non-default tile ordering
+//
+// Linear grids get hand-written per-dimension bindings below; these 
+// mirror the common part (ctor, add_tile, get_tile, id) for any D.
+template<size_t D, template<size_t> class Ordering, size_t... Is>
+auto declare_ordered_node(
+    py::module &m, 
+    const std::string& pyclass_name,
+    std::index_sequence<Is...> /*unused*/)
+{
+  using Grid_t = corgi::Grid<D, corgi::tools::dense_grid, Ordering>;
+
+  auto corgi_node = declare_node<D, Ordering>(m, pyclass_name);
+
+  corgi_node
+      .def(py::init<size_arg<Is>...>())
+      .def("add_tile", &Grid_t::add_tile, py::keep_alive<1,2>())
+      .def("get_tile", [](Grid_t& n, size_arg<Is>... indices){ 
+          return n.get_tileptr_ind(indices...); },
+          py::return_value_policy::reference,
+          py::keep_alive<1,0>()
+          )
+      .def("id", [](const Grid_t& n, size_arg<Is>... indices){ 
+          return n.id(indices...); });
+
   return corgi_node;
 }
 
 
+/// Tile ID engine (encode/decode between tile indices and cids)
+template<size_t D, template<size_t> class Ordering>
+auto declare_ordering(
+    py::module &m, 
+    const std::string& pyclass_name) 
+{
+  using Ordering_t = Ordering<D>;
+
+  py::class_<Ordering_t> corgi_ordering(m, pyclass_name.c_str());
+  corgi_ordering
+      .def(py::init<const std::array<size_t, D>&>())
+      .def("encode", &Ordering_t::encode)
+      .def("decode", &Ordering_t::decode);
+
+  return corgi_ordering;
+}
+
+
+/// Cellular automata neighborhoods; relative offsets in stencil order
+template<size_t D>
+void declare_neighborhoods(py::module &m)
+{
+  m.def("moore_neighborhood",       &corgi::ca::moore_neighborhood<D>);
+  m.def("chessboard_neighborhood",  &corgi::ca::chessboard_neighborhood<D>);
+  m.def("von_neumann_neighborhood", &corgi::ca::von_neumann_neighborhood<D>);
+  m.def("euler_neighborhood",       &corgi::ca::euler_neighborhood<D>);
+}
+
+
+/// Ordering engines and the corresponding grids of dimension D
+template<size_t D>
+void declare_orderings(py::module &m)
+{
+  declare_ordering<D, corgi::indexing::linear >(m, "LinearOrdering");
+  declare_ordering<D, corgi::indexing::morton >(m, "MortonOrdering");
+  declare_ordering<D, corgi::indexing::hilbert>(m, "HilbertOrdering");
+
+  declare_ordered_node<D, corgi::indexing::morton >(m, "MortonGrid",  std::make_index_sequence<D>{});
+  declare_ordered_node<D, corgi::indexing::hilbert>(m, "HilbertGrid", std::make_index_sequence<D>{});
+}
+
+
 
 
 // --------------------------------------------------
@@ -131,6 +224,16 @@ PYBIND11_MODULE(pycorgi, m_base) {
     //--------------------------------------------------
     // dimension independent bindings
 
+    // data exchange types for Grid.data_exchange
+    m_base.attr("PER_TILE")   = py::int_( static_cast<int>(exchangeType::PER_TILE)   );
+    m_base.attr("AGGREGATED") = py::int_( static_cast<int>(exchangeType::AGGREGATED) );
+    m_base.attr("HALO")       = py::int_( static_cast<int>(exchangeType::HALO)       );
+
+    // data transport types for Grid.data_transport
+    m_base.attr("POINT_TO_POINT")      = py::int_( static_cast<int>(transportType::POINT_TO_POINT)      );
+    m_base.attr("NEIGHBOR_COLLECTIVE") = py::int_( static_cast<int>(transportType::NEIGHBOR_COLLECTIVE) );
+    m_base.attr("ONE_SIDED")           = py::int_( static_cast<int>(transportType::ONE_SIDED)           );
+
     py::class_<corgi::Communication> corgi_comm(m_base, "Communication");
     corgi_comm
         .def_readwrite("cid",                         &corgi::Communication::cid                        )
@@ -238,6 +341,9 @@ PYBIND11_MODULE(pycorgi, m_base) {
     auto t1 = declare_tile<1>(m_1d, "Tile");
     t1.def("neighs", [](corgi::Tile<1> &t, int i ){ return t.neighs(i); });
 
+    declare_orderings<1>(m_1d);
+    declare_neighborhoods<1>(m_1d);
+
 
 
     //--------------------------------------------------
@@ -305,6 +411,9 @@ PYBIND11_MODULE(pycorgi, m_base) {
     auto t2 = declare_tile<2>(m_2d, "Tile");
     t2.def("neighs", [](corgi::Tile<2> &t, int i, int j){ return t.neighs(i,j); });
 
+    declare_orderings<2>(m_2d);
+    declare_neighborhoods<2>(m_2d);
+
 
     //--------------------------------------------------
     // 3D
@@ -367,6 +476,9 @@ PYBIND11_MODULE(pycorgi, m_base) {
     auto t3 = declare_tile<3>(m_3d, "Tile");
     t3.def("neighs", [](corgi::Tile<3> &t, int i, int j, int k){ return t.neighs(i,j,k); });
 
+    declare_orderings<3>(m_3d);
+    declare_neighborhoods<3>(m_3d);
+
 
 }
 
@@ -1,4 +1,6 @@
 #include <string>
+#include <array>
+#include <cassert>
 
 #include "corgitest.h"
 
@@ -18,5 +20,68 @@ std::string Viking::pray_for_odin() { return "Oooh Mighty Odin!"; }
 std::string Swede::fika() { return "---: It is fika time, get the kanelbullas"; }
 std::string Vallhund::bark() { return "ruf ruf ruf"; }
 
+// Cardigan methods
+std::vector<mpi4cpp::mpi::request> Cardigan::send_data( 
+    mpi4cpp::mpi::communicator& comm, int dest, int /*mode*/, int tag)
+{
+  std::vector<mpi4cpp::mpi::request> reqs;
+  reqs.push_back( comm.isend(dest, tag, data.data(), data.size()) );
+  return reqs;
+}
+
+std::vector<mpi4cpp::mpi::request> Cardigan::recv_data( 
+    mpi4cpp::mpi::communicator& comm, int orig, int /*mode*/, int tag)
+{
+  std::vector<mpi4cpp::mpi::request> reqs;
+  reqs.push_back( comm.irecv(orig, tag, data.data(), data.size()) );
+  return reqs;
+}
+
+void Cardigan::pack_data(corgi::tools::byte_writer& buf, int /*mode*/)
+{
+  buf.put(data.data(), data.size());
+}
+
+void Cardigan::unpack_data(corgi::tools::byte_reader& buf, int /*mode*/)
+{
+  assert(buf.remaining() == data.size()*sizeof(int));
+  buf.get(data.data(), data.size());
+}
+
+size_t Cardigan::packed_size(int /*mode*/)
+{
+  return data.size()*sizeof(int);
+}
+
+/// cells [i0,i1) x [j0,j1) next to the neighbor at dir
+static std::array<int,4> edge_strip(int n, const corgi::ca::offset_t<2>& dir)
+{
+  int i0 = dir[0] > 0 ? n-1 : 0;
+  int i1 = dir[0] < 0 ? 1   : n;
+  int j0 = dir[1] > 0 ? n-1 : 0;
+  int j1 = dir[1] < 0 ? 1   : n;
+
+  return {{i0, i1, j0, j1}};
+}
+
+void Cardigan::pack_halo(corgi::tools::byte_writer& buf, int /*mode*/, const corgi::ca::offset_t<2>& dir)
+{
+  auto r = edge_strip(n, dir);
+  for(int j=r[2]; j<r[3]; j++) buf.put(&data[r[0] + n*j], static_cast<size_t>(r[1] - r[0]));
+}
+
+void Cardigan::unpack_halo(corgi::tools::byte_reader& buf, int /*mode*/, const corgi::ca::offset_t<2>& dir)
+{
+  auto r = edge_strip(n, dir);
+  for(int j=r[2]; j<r[3]; j++) buf.get(&data[r[0] + n*j], static_cast<size_t>(r[1] - r[0]));
+}
+
+size_t Cardigan::halo_size(int /*mode*/, const corgi::ca::offset_t<2>& dir)
+{
+  auto r = edge_strip(n, dir);
+  return static_cast<size_t>( (r[1] - r[0])*(r[3] - r[2]) )*sizeof(int);
+}
+
+
 // Grid methods
 //std::string Grid::pet_shop() { return "No Corgis for sale."; }
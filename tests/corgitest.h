@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 
 #include "../tile.h"
 
@@ -105,6 +106,48 @@ class Vallhund : public Swede,
 
 
 
+/// \brief Cardigan carries a small mesh of data for the exchange tests
+//
+//  Values are moved with send_data/recv_data (per-tile exchange),
+//  pack_data/unpack_data (aggregated exchange) and pack_halo/unpack_halo
+//  (halo exchange). The halo region towards a neighbor is the row/column
+//  of cells next to it.
+class Cardigan : public corgi::Tile<2> {
+
+  public:
+
+    /// mesh side length
+    static constexpr int n = 4;
+
+    /// mesh values; column-major n x n
+    std::vector<int> data;
+
+    Cardigan() : data(n*n, 0) { }
+
+    ~Cardigan() override = default;
+
+    std::vector<mpi4cpp::mpi::request> 
+    send_data(mpi4cpp::mpi::communicator&, int dest, int mode, int tag) override;
+
+    std::vector<mpi4cpp::mpi::request> 
+    recv_data(mpi4cpp::mpi::communicator&, int orig, int mode, int tag) override;
+
+    void pack_data(corgi::tools::byte_writer&, int mode) override;
+
+    void unpack_data(corgi::tools::byte_reader&, int mode) override;
+
+    size_t packed_size(int mode) override;
+
+    void pack_halo(corgi::tools::byte_writer&, int mode, const corgi::ca::offset_t<2>& dir) override;
+
+    void unpack_halo(corgi::tools::byte_reader&, int mode, const corgi::ca::offset_t<2>& dir) override;
+
+    size_t halo_size(int mode, const corgi::ca::offset_t<2>& dir) override;
+
+};
+
+
+
 //class Grid : public corgi::Grid<2> {
 //  public:
 //    Grid(size_t nx, size_t ny) : corgi::Grid<2>(nx, ny) { }
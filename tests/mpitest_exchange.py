@@ -0,0 +1,94 @@
+from mpi4py import MPI
+
+import unittest
+
+import pycorgi
+import pycorgitest
+
+from test_exchange import N, dirs, on_edge
+
+
+def value(cid, k, lap):
+    return cid*1000 + k + lap
+
+
+# every exchange mode and transport delivers what the per-tile exchange does
+class Transports(unittest.TestCase):
+
+    Nx = 6
+    Ny = 5
+
+    def setUp(self):
+        self.grid = pycorgi.twoD.Grid(self.Nx, self.Ny)
+        self.grid.set_grid_lims(0.0, 1.0, 0.0, 1.0)
+        pycorgitest.set_tile_type(self.grid)
+
+        #nothing crosses ranks otherwise; see check-pycorgi-mpi
+        self.assertGreater( self.grid.size(), 1 )
+
+        # column stripes
+        if self.grid.master():
+            for i in range(self.Nx):
+                for j in range(self.Ny):
+                    self.grid.set_mpi_grid(i, j, (i*self.grid.size())//self.Nx)
+        self.grid.bcast_mpi_grid()
+
+        for i in range(self.Nx):
+            for j in range(self.Ny):
+                if self.grid.get_mpi_grid(i,j) == self.grid.rank():
+                    self.grid.add_tile(pycorgitest.Cardigan(), (i,j) )
+
+        self.grid.analyze_boundaries()
+        self.grid.send_tiles()
+        self.grid.recv_tiles()
+
+    def exchange(self, lap):
+        for cid in self.grid.get_local_tiles():
+            c = self.grid.get_tile(cid)
+            c.data = [ value(cid, k, lap) for k in range(N*N) ]
+
+        self.grid.send_data(0)
+        self.grid.recv_data(0)
+        self.grid.wait_data(0)
+
+    def check(self, lap, halo):
+        for cid in self.grid.get_virtual_tiles():
+            c = self.grid.get_tile(cid)
+
+            #halo exchange only fills the strips facing my tiles
+            faces = []
+            if halo:
+                cids, owners = self.grid.get_neighborhood(cid)
+                faces = [ d for d, o in zip(dirs, owners) if o == self.grid.rank() ]
+
+            for j in range(N):
+                for i in range(N):
+                    if halo and not any(on_edge(i, j, d) for d in faces):
+                        continue
+                    k = i + N*j
+                    self.assertEqual( c.data[k], value(cid, k, lap) )
+
+    def test_factory(self):
+        #virtual tiles are built with the registered type
+        self.assertNotEqual( self.grid.get_virtual_tiles(), [] )
+
+        for cid in self.grid.get_virtual_tiles():
+            self.assertTrue( isinstance(self.grid.get_tile(cid), pycorgitest.Cardigan) )
+
+    def test_transports(self):
+        exchanges  = [ pycorgi.PER_TILE, pycorgi.AGGREGATED, pycorgi.HALO ]
+        transports = [ pycorgi.POINT_TO_POINT, pycorgi.NEIGHBOR_COLLECTIVE, pycorgi.ONE_SIDED ]
+
+        lap = 0
+        for exch in exchanges:
+            for tr in transports:
+                self.grid.data_exchange  = exch
+                self.grid.data_transport = tr
+
+                lap += 1
+                self.exchange(lap)
+                self.check(lap, exch == pycorgi.HALO)
+
+
+if __name__ == '__main__':
+    unittest.main()
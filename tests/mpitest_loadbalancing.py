@@ -0,0 +1,168 @@
+from mpi4py import MPI
+
+import unittest
+import math
+
+import pycorgi
+
+
+def load_stripes(grid, Nx, Ny):
+    # column stripes; every rank sets the same ownership
+    for i in range(Nx):
+        for j in range(Ny):
+            grid.set_mpi_grid(i, j, (i*grid.size())//Nx )
+
+    for i in range(Nx):
+        for j in range(Ny):
+            if grid.get_mpi_grid(i,j) == grid.rank():
+                c = pycorgi.twoD.Tile()
+                grid.add_tile(c, (i,j) ) 
+
+def set_work(grid, lap):
+    # uneven and changing work so that tiles move
+    for cid in grid.get_local_tiles():
+        (i, j) = grid.get_tile(cid).index
+        w = 1.0 + (1.0 if grid.rank() == 0 else 0.0) + 0.37*((cid*7919 + lap*104729) % 13)
+        grid.set_work_grid(i, j, w)
+    grid.allgather_work_grid()
+
+
+def baseline_council(owners, work, Nx, Ny, P):
+    # full-grid sweep of the original replicated adoption_council2
+    total = 0.0
+    loads = [0.0]*P
+    for i in range(Nx):
+        for j in range(Ny):
+            total += work[i][j]
+            loads[owners[i][j]] += work[i][j]
+    rel_quota = [ P*(total/P - loads[r])/total for r in range(P) ]
+
+    Ng = int(math.sqrt(max(Nx, Ny)))
+    Rg = float(Ng)
+    norm = 1.0/math.sqrt(math.pow(2.0*math.pi, 2)*Rg*Rg)
+    kernel = pycorgi.twoD.chessboard_neighborhood(Ng)
+
+    def owner(i, j):
+        return owners[i % Nx][j % Ny]
+
+    new = [ list(col) for col in owners ]
+    for i in range(Nx):
+        for j in range(Ny):
+            old = owners[i][j]
+
+            alives = [0.0]*P
+            alives[old] = norm
+            for (di, dj) in kernel:
+                r = float(abs(di) + abs(dj))
+                alives[owner(i+di, j+dj)] += norm*math.exp(-0.5*r*r/Rg/Rg)
+
+            # summed in order like the C++ loop
+            loop_norm = 0.0
+            for a in alives:
+                loop_norm += a
+            alives = [ a/loop_norm + 0.5*q for a, q in zip(alives, rel_quota) ]
+            color = alives.index(max(alives))
+
+            #tiles only move to a rank that already owns a Moore neighbor
+            if color != old:
+                for (di, dj) in pycorgi.twoD.moore_neighborhood():
+                    if owner(i+di, j+dj) == color:
+                        new[i][j] = color
+                        break
+    return new
+
+
+class Councils(unittest.TestCase):
+
+    Nx = 20
+    Ny = 14
+
+    def setUp(self):
+        #nothing moves between ranks otherwise; see check-pycorgi-mpi
+        self.assertGreater( MPI.COMM_WORLD.Get_size(), 1 )
+
+    def test_distributed(self):
+        # distributed council comes to the same conclusion as the replicated one
+        ref  = pycorgi.twoD.Grid(self.Nx, self.Ny)
+        grid = pycorgi.twoD.Grid(self.Nx, self.Ny)
+
+        for g in [ref, grid]:
+            g.set_grid_lims(0.0, 1.0, 0.0, 1.0)
+            load_stripes(g, self.Nx, self.Ny)
+
+        for lap in range(8):
+            for g in [ref, grid]:
+                g.analyze_boundaries()
+                g.send_tiles()
+                g.recv_tiles()
+                set_work(g, lap)
+
+            for r in range(grid.size()):
+                self.assertEqual( ref.get_quota(r), grid.get_quota(r) )
+
+            ref.adoption_council2()
+            grid.adoption_council_distributed()
+
+            self.assertEqual( ref.get_local_tiles(), grid.get_local_tiles() )
+
+            #owners around my tiles are kept exact
+            for cid in grid.get_local_tiles():
+                (i, j) = grid.get_tile(cid).index
+                for di in [-1, 0, 1]:
+                    for dj in [-1, 0, 1]:
+                        ii = (i + di) % self.Nx
+                        jj = (j + dj) % self.Ny
+                        self.assertEqual( ref.get_mpi_grid(ii,jj), grid.get_mpi_grid(ii,jj) )
+
+            for g in [ref, grid]:
+                g.erase_virtuals()
+
+        #whole owner grid is rebuilt on request
+        self.assertTrue( grid.owners_partial() )
+        grid.allgather_mpi_grid()
+        self.assertFalse( grid.owners_partial() )
+
+        for i in range(self.Nx):
+            for j in range(self.Ny):
+                self.assertEqual( ref.get_mpi_grid(i,j), grid.get_mpi_grid(i,j) )
+
+    def test_baseline(self):
+        # frontier-limited council moves exactly the tiles the full sweep does
+        grid = pycorgi.twoD.Grid(self.Nx, self.Ny)
+        grid.set_grid_lims(0.0, 1.0, 0.0, 1.0)
+        load_stripes(grid, self.Nx, self.Ny)
+
+        for lap in range(10):
+            grid.analyze_boundaries()
+            grid.send_tiles()
+            grid.recv_tiles()
+
+            # same work on every rank; halves keep the sums exact
+            owners = [ [ grid.get_mpi_grid(i,j) for j in range(self.Ny) ] for i in range(self.Nx) ]
+            work   = [ [ 0.0 ]*self.Ny for i in range(self.Nx) ]
+            for i in range(self.Nx):
+                for j in range(self.Ny):
+                    w = 1.0 + 0.5*(((i + self.Nx*j)*7 + lap*3) % 5)
+                    if owners[i][j] == 0:
+                        w += 1.0
+                    work[i][j] = w
+                    grid.set_work_grid(i, j, w)
+
+            #quotas from loads summed over the whole grid
+            total = sum( sum(col) for col in work )
+            for r in range(grid.size()):
+                load = sum( w for ocol, wcol in zip(owners, work) for o, w in zip(ocol, wcol) if o == r )
+                self.assertEqual( grid.get_quota(r), total/grid.size() - load )
+
+            ref = baseline_council(owners, work, self.Nx, self.Ny, grid.size())
+            grid.adoption_council2()
+
+            for i in range(self.Nx):
+                for j in range(self.Ny):
+                    self.assertEqual( grid.get_mpi_grid(i,j), ref[i][j] )
+
+            grid.erase_virtuals()
+
+
+if __name__ == '__main__':
+    unittest.main()
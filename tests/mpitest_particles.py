@@ -0,0 +1,113 @@
+from mpi4py import MPI
+
+import unittest
+
+import pycorgi.twoD as pycorgi
+import pyprtcls
+
+
+def load_tiles(grid, nspecies):
+    for i in range(grid.get_Nx()):
+        for j in range(grid.get_Ny()):
+            if grid.get_mpi_grid(i,j) == grid.rank():
+                c = pyprtcls.Tile()
+                c.set_tile_mins([float(i),   float(j)  ])
+                c.set_tile_maxs([float(i+1), float(j+1)])
+
+                for ispc in range(nspecies):
+                    c.set_container( pyprtcls.ParticleBlock(1,1,1) )
+
+                grid.add_tile(c, (i,j))
+
+def wrap(x, L):
+    while x < 0.0:
+        x += L
+    while x >= L:
+        x -= L
+    return x
+
+
+# particles are moved straight into the tile that contains them
+class Routing(unittest.TestCase):
+
+    Nx = 5
+    Ny = 4
+    Nspecies = 2
+
+    # jumps over several tiles and across the periodic boundaries
+    jumps = [ (0.0, 0.0), (3.0, 0.0), (-2.0, 1.0), (7.0, -5.0), (-1.0, -9.0) ]
+
+    def setUp(self):
+        self.grid = pycorgi.Grid(self.Nx, self.Ny)
+        self.grid.set_grid_lims(0.0, float(self.Nx), 0.0, float(self.Ny))
+
+        #jumps only cross ranks otherwise; see check-pycorgi-mpi
+        self.assertGreater( self.grid.size(), 1 )
+
+        # column stripes so that the jumps cross ranks
+        if self.grid.master():
+            for i in range(self.Nx):
+                for j in range(self.Ny):
+                    self.grid.set_mpi_grid(i, j, (i*self.grid.size())//self.Nx)
+        self.grid.bcast_mpi_grid()
+
+        load_tiles(self.grid, self.Nspecies)
+
+    def inject(self):
+        # weight tags each particle by its tile, species and jump
+        n = 0
+        for cid in self.grid.get_local_tiles():
+            c = self.grid.get_tile(cid)
+            i,j = c.index
+            for ispc in range(self.Nspecies):
+                for k, (dx, dy) in enumerate(self.jumps):
+                    w = 1.0 + cid*100 + ispc*10 + k
+                    c.get_container(ispc).add_particle(
+                            [i + 0.5 + dx, j + 0.25 + dy, 2.5], [0.0, 0.0, 0.0], w)
+                    n += 1
+        return n
+
+    def expected(self, w):
+        cid  = int(w - 1.0) // 100
+        k    = int(w - 1.0) % 10
+        i, j = cid % self.Nx, cid // self.Nx
+        dx, dy = self.jumps[k]
+        return wrap(i + 0.5 + dx, self.Nx), wrap(j + 0.25 + dy, self.Ny)
+
+    def test_route(self):
+        comm = MPI.COMM_WORLD
+
+        for lap in range(3):
+            ninj = self.inject()
+            pyprtcls.route_particles(self.grid, lap)
+
+            n = 0
+            for cid in self.grid.get_local_tiles():
+                c = self.grid.get_tile(cid)
+                for ispc in range(self.Nspecies):
+                    container = c.get_container(ispc)
+                    xs = container.loc(0)
+                    ys = container.loc(1)
+                    zs = container.loc(2)
+                    ws = container.wgt()
+
+                    for x, y, z, w in zip(xs, ys, zs, ws):
+                        #inside the tile and at the wrapped position
+                        self.assertTrue( c.mins[0] <= x < c.maxs[0] )
+                        self.assertTrue( c.mins[1] <= y < c.maxs[1] )
+
+                        xr, yr = self.expected(w)
+                        self.assertAlmostEqual(x, xr)
+                        self.assertAlmostEqual(y, yr)
+                        self.assertEqual(z, 2.5) # not a grid dimension
+                        self.assertEqual( int(w - 1.0) // 10 % 10, ispc )
+
+                    n += len(ws)
+                c.delete_all_particles()
+
+            #nothing is lost or duplicated
+            self.assertEqual( comm.allreduce(n), comm.allreduce(ninj) )
+
+
+if __name__ == '__main__':
+    unittest.main()
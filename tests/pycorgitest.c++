@@ -3,6 +3,7 @@
 namespace py = pybind11;
     
 #include "corgitest.h"
+#include "../corgi.h"
 
 
 PYBIND11_MODULE(pycorgitest, m) {
@@ -57,6 +58,52 @@ PYBIND11_MODULE(pycorgitest, m) {
 
 
 
+  // Cardigan carries data for the exchange tests
+  py::class_<corgitest::Cardigan, corgi::Tile<2>, std::shared_ptr<corgitest::Cardigan>>(m, "Cardigan")
+    .def(py::init<>())
+    .def_readwrite("data", &corgitest::Cardigan::data);
+
+  // incoming virtual tiles are built as Cardigans
+  m.def("set_tile_type", [](corgi::Grid<2>& grid) 
+      { 
+        grid.set_tile_type<corgitest::Cardigan>(); 
+      });
+
+  // serialization used by the aggregated and halo exchanges
+  m.def("pack_data", [](corgi::Tile<2>& tile, int mode) 
+      {
+        std::vector<char> buf;
+        corgi::tools::byte_writer out(buf);
+        tile.pack_data(out, mode);
+        return py::bytes(buf.data(), buf.size());
+      });
+
+  m.def("unpack_data", [](corgi::Tile<2>& tile, const std::string& bytes, int mode) 
+      {
+        corgi::tools::byte_reader in(bytes.data(), bytes.size());
+        tile.unpack_data(in, mode);
+      });
+
+  m.def("pack_halo", [](corgi::Tile<2>& tile, int mode, corgi::ca::offset_t<2> dir) 
+      {
+        std::vector<char> buf;
+        corgi::tools::byte_writer out(buf);
+        tile.pack_halo(out, mode, dir);
+        return py::bytes(buf.data(), buf.size());
+      });
+
+  m.def("unpack_halo", [](corgi::Tile<2>& tile, const std::string& bytes, int mode, corgi::ca::offset_t<2> dir) 
+      {
+        corgi::tools::byte_reader in(bytes.data(), bytes.size());
+        tile.unpack_halo(in, mode, dir);
+      });
+
+  m.def("halo_size", [](corgi::Tile<2>& tile, int mode, corgi::ca::offset_t<2> dir) 
+      {
+        return tile.halo_size(mode, dir);
+      });
+
+
   // --------------------------------------------------
   // Grid bindings
   //py::object corgi_node = (py::object) py::module::import("pycorgi.twoD").attr("Grid");
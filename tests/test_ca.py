@@ -4,9 +4,67 @@ import unittest
 import numpy as np
 
 import pycorgi
+import itertools
 
 
 
+def box(D, radius):
+    # offsets of [-R,R]^D with the first index running fastest
+    rng = range(-radius, radius+1)
+    return [ tuple(reversed(rel)) for rel in itertools.product(rng, repeat=D) ]
+
+def ref_stencil(D, radius, inside):
+    return [ rel for rel in box(D, radius) if any(rel) and inside(rel) ]
+
+
+class Stencils(unittest.TestCase):
+
+    modules = {
+        1: pycorgi.oneD,
+        2: pycorgi.twoD,
+        3: pycorgi.threeD,
+        }
+
+    def test_moore(self):
+        self.assertEqual( pycorgi.oneD.moore_neighborhood(), [(-1,), (1,)] )
+
+        self.assertEqual( pycorgi.twoD.moore_neighborhood(), 
+                [(-1,-1), (0,-1), (1,-1), 
+                 (-1, 0),         (1, 0), 
+                 (-1, 1), (0, 1), (1, 1)] )
+
+        nh = pycorgi.threeD.moore_neighborhood()
+        self.assertEqual( len(nh), 26 )
+        self.assertEqual( nh[0],  (-1,-1,-1) )
+        self.assertEqual( nh[12], (-1, 0, 0) )
+        self.assertEqual( nh[13], ( 1, 0, 0) )
+        self.assertEqual( nh[25], ( 1, 1, 1) )
+        self.assertEqual( nh, ref_stencil(3, 1, lambda rel: True) )
+
+    def test_chessboard(self):
+        for D, m in self.modules.items():
+            for radius in [1, 2, 3]:
+                self.assertEqual( m.chessboard_neighborhood(radius), 
+                        ref_stencil(D, radius, lambda rel: True) )
+
+    def test_von_neumann(self):
+        for D, m in self.modules.items():
+            for radius in [1, 2, 3]:
+                self.assertEqual( m.von_neumann_neighborhood(radius), 
+                        ref_stencil(D, radius, lambda rel: sum(abs(r) for r in rel) <= radius) )
+
+    def test_euler(self):
+        # closed interval in 1D
+        for radius in [1, 2, 3]:
+            self.assertEqual( pycorgi.oneD.euler_neighborhood(radius), 
+                    pycorgi.oneD.chessboard_neighborhood(radius) )
+
+        for D in [2, 3]:
+            for radius in [1, 2, 3]:
+                self.assertEqual( self.modules[D].euler_neighborhood(radius), 
+                        ref_stencil(D, radius, lambda rel: sum(r*r for r in rel) < radius*radius) )
+
+
 class Neighboords(unittest.TestCase):
     Nx = 3
     Ny = 3
@@ -74,32 +132,30 @@ class Neighboords(unittest.TestCase):
                 q += 1
 
 
-    def skip_test_nhood_3d(self):
+    def test_nhood_3d(self):
         grid = pycorgi.threeD.Grid(self.Nx, self.Ny, self.Nz)
 
+        tiles = []
         if grid.master():
             for i in range(grid.get_Nx()):
                 for j in range(grid.get_Ny()):
                     for k in range(grid.get_Nz()):
                         c = pycorgi.threeD.Tile()
                         grid.add_tile(c, (i,j,k) ) 
+                        tiles.append(c)
 
-        # TODO: add reference
-        #ref_nhood = [
-        #]
-
-        q = 0
+        lens = (self.Nx, self.Ny, self.Nz)
         for i in range(grid.get_Nx()):
             for j in range(grid.get_Ny()):
                 for k in range(grid.get_Nz()):
-                    print("ijk", i,j,k)
                     cid = grid.id(i,j,k)
                     c = grid.get_tile(cid)
-                    print(c.nhood())
-                    #self.assertCountEqual( c.nhood(), ref_nhood[q] )
-
-                    q += 1
 
+                    # wrapped Moore stencil in stencil order
+                    ref_nhood = [ 
+                        tuple( (x + r) % n for x, r, n in zip((i,j,k), rel, lens) )
+                        for rel in pycorgi.threeD.moore_neighborhood() ]
+                    self.assertEqual( list(c.nhood()), ref_nhood )
 
 
 
@@ -0,0 +1,62 @@
+from mpi4py import MPI
+
+import unittest
+
+import pycorgi
+import pycorgitest
+
+
+# mesh side length of pycorgitest.Cardigan
+N = 4
+
+# Moore neighborhood directions in the order of the grid's tables
+dirs = pycorgi.twoD.moore_neighborhood()
+
+
+def on_edge(i, j, d):
+    # cell (i,j) is next to the neighbor at d
+    di, dj = d
+    ok  = di == 0 or i == (N-1 if di > 0 else 0)
+    ok &= dj == 0 or j == (N-1 if dj > 0 else 0)
+    return ok
+
+
+# tile (de)serialization against the full-tile copy
+class Serialization(unittest.TestCase):
+
+    def setUp(self):
+        self.tile = pycorgitest.Cardigan()
+        self.tile.data = [ 3*k + 1 for k in range(N*N) ]
+
+    def test_roundtrip(self):
+        #aggregated exchange carries everything that send_data does
+        buf = pycorgitest.pack_data(self.tile, 0)
+        self.assertEqual( len(buf), 4*N*N )
+
+        tile = pycorgitest.Cardigan()
+        pycorgitest.unpack_data(tile, buf, 0)
+        self.assertEqual( tile.data, self.tile.data )
+
+    def test_halo_roundtrip(self):
+        full = pycorgitest.Cardigan()
+        pycorgitest.unpack_data(full, pycorgitest.pack_data(self.tile, 0), 0)
+
+        for d in dirs:
+            buf = pycorgitest.pack_halo(self.tile, 0, d)
+            self.assertEqual( len(buf), pycorgitest.halo_size(self.tile, 0, d) )
+
+            tile = pycorgitest.Cardigan()
+            pycorgitest.unpack_halo(tile, buf, 0, d)
+
+            #strip next to the reader equals the full copy; nothing else is touched
+            for j in range(N):
+                for i in range(N):
+                    k = i + N*j
+                    if on_edge(i, j, d):
+                        self.assertEqual( tile.data[k], full.data[k] )
+                    else:
+                        self.assertEqual( tile.data[k], 0 )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,161 @@
+from mpi4py import MPI
+
+import unittest
+import itertools
+
+import pycorgi
+
+
+orderings = ["LinearOrdering", "MortonOrdering", "HilbertOrdering"]
+
+modules = {
+        1: pycorgi.oneD,
+        2: pycorgi.twoD,
+        3: pycorgi.threeD,
+        }
+
+def all_indices(lens):
+    return itertools.product( *[range(n) for n in lens] )
+
+def manhattan(a, b):
+    return sum( abs(x-y) for x,y in zip(a,b) )
+
+def prod(lens):
+    n = 1
+    for l in lens:
+        n *= l
+    return n
+
+
+# tile ID engines
+class Orderings(unittest.TestCase):
+
+    lens = {
+        1: [7],
+        2: [5, 3],
+        3: [3, 4, 2],
+        }
+
+    def test_roundtrip(self):
+        for D, lens in self.lens.items():
+            for name in orderings:
+                o = getattr(modules[D], name)(lens)
+
+                cids = set()
+                for ind in all_indices(lens):
+                    cid = o.encode(list(ind))
+                    self.assertEqual( tuple(o.decode(cid)), ind )
+                    cids.add(cid)
+
+                #ids are unique
+                self.assertEqual( len(cids), prod(lens) )
+
+    def test_linear(self):
+        # linear ordering is the column-major id of the default grid
+        grid = pycorgi.twoD.Grid(5, 3)
+        o = pycorgi.twoD.LinearOrdering([5, 3])
+
+        for ind in all_indices([5, 3]):
+            self.assertEqual( o.encode(list(ind)), grid.id(*ind) )
+
+    def test_oneD(self):
+        # all orderings agree in 1D
+        for name in orderings:
+            o = getattr(pycorgi.oneD, name)([7])
+            for i in range(7):
+                self.assertEqual( o.encode([i]), i )
+
+    def test_morton_blocks(self):
+        # 2^D blocks of tiles get consecutive ids
+        for D, lens in [(2, [4, 4]), (3, [4, 4, 4])]:
+            o = getattr(modules[D], "MortonOrdering")(lens)
+
+            for ind in all_indices(lens):
+                if ind[0] % 2 == 1:
+                    continue
+                nxt = list(ind)
+                nxt[0] += 1
+                self.assertEqual( o.encode(nxt) - o.encode(list(ind)), 1 )
+
+            #power-of-two grid is filled contiguously
+            cids = sorted( o.encode(list(ind)) for ind in all_indices(lens) )
+            self.assertEqual( cids, list(range(prod(lens))) )
+
+    def test_hilbert_neighbors(self):
+        # consecutive ids are face neighbors on power-of-two grids
+        for D, lens in [(2, [4, 4]), (2, [8, 8]), (3, [4, 4, 4])]:
+            o = getattr(modules[D], "HilbertOrdering")(lens)
+
+            curve = sorted( (o.encode(list(ind)), ind) for ind in all_indices(lens) )
+            for (c0, i0), (c1, i1) in zip(curve[:-1], curve[1:]):
+                self.assertEqual( manhattan(i0, i1), 1 )
+
+
+# grids with the space-filling-curve orderings
+class OrderedGrids(unittest.TestCase):
+
+    lens = {
+        1: [5],
+        2: [5, 3],
+        3: [3, 4, 3],
+        }
+
+    def load(self, grid, D, lens):
+        tiles = []
+        for ind in all_indices(lens):
+            c = modules[D].Tile()
+            grid.add_tile(c, ind)
+            tiles.append(c)
+        return tiles
+
+    def test_ids(self):
+        for D, lens in self.lens.items():
+            for name in ["Morton", "Hilbert"]:
+                grid = getattr(modules[D], name + "Grid")(*lens)
+                o    = getattr(modules[D], name + "Ordering")(lens)
+
+                for ind in all_indices(lens):
+                    self.assertEqual( grid.id(*ind), o.encode(list(ind)) )
+
+    def test_loading(self):
+        for D, lens in self.lens.items():
+            for name in ["Morton", "Hilbert"]:
+                grid = getattr(modules[D], name + "Grid")(*lens)
+                o    = getattr(modules[D], name + "Ordering")(lens)
+                tiles = self.load(grid, D, lens)
+
+                cids = [ o.encode(list(ind)) for ind in all_indices(lens) ]
+
+                #tile lists are sorted by the curve
+                self.assertEqual( grid.get_local_tiles(), sorted(cids) )
+                self.assertEqual( grid.get_virtual_tiles(), [] )
+
+                for ind in all_indices(lens):
+                    c = grid.get_tile(*ind)
+                    self.assertEqual( c.cid, grid.id(*ind) )
+                    self.assertEqual( tuple(c.index), ind )
+
+    def test_nhood(self):
+        # neighborhoods do not depend on the ordering
+        for D, lens in self.lens.items():
+            ref = modules[D].Grid(*lens)
+            ref_tiles = self.load(ref, D, lens)
+
+            for name in ["Morton", "Hilbert"]:
+                grid = getattr(modules[D], name + "Grid")(*lens)
+                tiles = self.load(grid, D, lens)
+
+                for ind in all_indices(lens):
+                    c  = grid.get_tile(grid.id(*ind))
+                    cr = ref.get_tile(ref.id(*ind))
+                    self.assertEqual( c.nhood(), cr.nhood() )
+
+                    #and every neighbor resolves to the right tile
+                    for nind in c.nhood():
+                        n = grid.get_tile(grid.id(*nind))
+                        self.assertEqual( tuple(n.index), tuple(nind) )
+
+
+
+if __name__ == '__main__':
+    unittest.main()
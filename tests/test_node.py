@@ -45,6 +45,15 @@ class Initialization(unittest.TestCase):
         self.assertEqual( self.grid.get_ymin(), self.ymin )
         self.assertEqual( self.grid.get_ymax(), self.ymax )
 
+    def test_defaultLims(self):
+        # limits are zero until set_grid_lims is called
+        grid = pycorgi.Grid(self.Nx, self.Ny)
+
+        self.assertEqual( grid.get_xmin(), 0.0 )
+        self.assertEqual( grid.get_xmax(), 0.0 )
+        self.assertEqual( grid.get_ymin(), 0.0 )
+        self.assertEqual( grid.get_ymax(), 0.0 )
+
 
 def tile_id(i,j,Nx,Ny):
     return j*Nx + i
@@ -92,6 +101,13 @@ class Parallel(unittest.TestCase):
                 cidr = tile_id( i, j, self.grid.get_Nx(), self.grid.get_Ny() )
                 self.assertEqual(cid, cidr)
 
+    def test_id2index(self):
+        for j in range(self.grid.get_Ny()):
+            for i in range(self.grid.get_Nx()):
+                c = pycorgi.Tile()
+                self.grid.add_tile(c, (i,j) ) 
+                self.assertEqual( c.get_index(self.grid), (i,j) )
+
     def test_loading(self):
 
         #load tiles
@@ -106,6 +122,10 @@ class Parallel(unittest.TestCase):
         cids = self.grid.get_tile_ids() 
         self.assertEqual( len(cids), self.Nx*self.Ny )
 
+        #classification lists are kept up-to-date and sorted
+        self.assertEqual( self.grid.get_local_tiles(), sorted(cids) )
+        self.assertEqual( self.grid.get_virtual_tiles(), [] )
+
         #now try and get then back
         for cid in cids:
             c = self.grid.get_tile(cid)
@@ -223,6 +243,66 @@ class Parallel2(unittest.TestCase):
             self.assertEqual(c.cid, cid)
 
 
+# cached neighborhood tables against the tiles' own stencil
+class Neighborhoods(unittest.TestCase):
+
+    Nx = 6
+    Ny = 5
+
+    def setUp(self):
+        self.grid = pycorgi.Grid(self.Nx, self.Ny)
+        self.grid.set_grid_lims(0.0, 1.0, 0.0, 1.0)
+
+        for j in range(self.Ny):
+            for i in range(self.Nx):
+                c = pycorgi.Tile()
+                self.grid.add_tile(c, (i,j) )
+
+    def check(self):
+        for cid in self.grid.get_tile_ids():
+            c = self.grid.get_tile(cid)
+            cids, owners = self.grid.get_neighborhood(cid)
+
+            nhood = c.nhood()
+            self.assertEqual( len(cids),   len(nhood) )
+            self.assertEqual( len(owners), len(nhood) )
+
+            for n, (i,j) in enumerate(nhood):
+                self.assertEqual( cids[n],   self.grid.id(i,j) )
+                self.assertEqual( owners[n], self.grid.get_mpi_grid(i,j) )
+
+    def test_tables(self):
+        self.check()
+
+    def test_owner_change(self):
+        self.check()
+
+        #tables follow the mpi grid
+        self.grid.set_mpi_grid(2, 3, 7)
+        self.grid.set_mpi_grid(0, 0, 5)
+        self.grid.set_mpi_grid(self.Nx-1, self.Ny-1, 4)
+        self.check()
+
+    def test_new_tiles(self):
+        #tables are rebuilt for a grid that grows
+        grid = pycorgi.Grid(self.Nx, self.Ny)
+        grid.set_grid_lims(0.0, 1.0, 0.0, 1.0)
+        for i in range(self.Nx):
+            grid.add_tile(pycorgi.Tile(), (i,0) )
+
+        cids, owners = grid.get_neighborhood(grid.id(0,0))
+        before = list(owners)
+
+        for i in range(self.Nx):
+            grid.add_tile(pycorgi.Tile(), (i,1) )
+        grid.set_mpi_grid(0, 1, grid.size() + 3)
+
+        self.grid = grid
+        self.check()
+        cids, owners = grid.get_neighborhood(grid.id(0,0))
+        self.assertNotEqual( list(owners), before )
+
+
 if __name__ == '__main__':
     unittest.main()
 
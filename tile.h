@@ -10,6 +10,7 @@
 #include "common.h"
 #include "internals.h"
 #include "cellular_automata.h"
+#include "toolbox/byte_stream.h"
 
 #include <mpi4cpp/mpi.h>
 
@@ -27,7 +28,7 @@ namespace mpi = mpi4cpp::mpi;
 struct Communication {
 
   /// my index
-  int cid;
+  uint64_t cid;
 
   /// (i,j,k) indices
   std::array<int, 3> indices;
@@ -101,6 +102,18 @@ class Tile
      */
     virtual ~Tile() = default;
 
+    /*! \brief Prepare tile for re-use 
+     *
+     * Called by the grid when a retired (virtual) tile is taken back from 
+     * its tile pool. Reset any state here but keep the allocated buffers 
+     * so that the tile can be re-filled without new allocations.
+     */
+    virtual void recycle()
+    {
+      virtual_owners.clear();
+      communication = Communication();
+    }
+
     /// load tile metainfo from Communication object
     void load_metainfo(Communication cm)
     {
@@ -155,6 +168,16 @@ class Tile
         return ret;
     }
 
+    /// index of tile at relative offset (e.g., from corgi::ca stencils)
+    corgi::internals::tuple_of<D, size_t> neighs(const corgi::ca::offset_t<D>& rel)
+    {
+      auto cur = corgi::internals::into_array(index);
+      for(size_t i=0; i<D; i++) {
+        cur[i] = wrap( rel[i] + static_cast<int>(cur[i]), i);
+      }
+      return corgi::internals::into_tuple(cur);
+    }
+
     /// auxiliary function to unpack tuples
   private:
     template <size_t... Is>
@@ -179,12 +202,12 @@ class Tile
 
 
     /// Return full Moore neighborhood around me
-    std::vector< corgi::internals::tuple_of<D, size_t> > nhood()
+    std::array< corgi::internals::tuple_of<D, size_t>, corgi::ca::moore_size<D>() > nhood()
     {
-      std::vector< corgi::internals::tuple_of<D, size_t> > nh;
-      for(auto& reli : corgi::ca::moore_neighborhood<D>() ){
-        nh.push_back( neighs(reli) );
-      }
+      static constexpr auto stencil = corgi::ca::moore_stencil<D>();
+
+      std::array< corgi::internals::tuple_of<D, size_t>, stencil.size() > nh;
+      for(size_t n=0; n<stencil.size(); n++) nh[n] = neighs(stencil[n]);
       return nh;
     }
 
@@ -254,6 +277,79 @@ class Tile
       return reqs;
     }
 
+    /*! \brief Finish receiving data of unknown size
+     *
+     * Called by Grid::wait_data for every tile that recv_data was called
+     * for, once the requests it returned are complete. Messages whose
+     * size is not known up front can be probed and received here; the
+     * matching sends never wait for receives so blocking is safe.
+     */
+    virtual void wait_data(
+        mpi::communicator& /*comm*/,
+        int /*orig*/,
+        int /*mode*/,
+        int /*tag*/)
+    { }
+
+
+    /*! \brief Serialize data for the aggregated exchange
+     *
+     * Used instead of send_data when the grid runs with 
+     * exchangeType::AGGREGATED; everything that send_data(mode) would 
+     * send is appended to buf. The grid frames each tile separately so 
+     * the layout is entirely up to the tile.
+     */
+    virtual void pack_data(
+        corgi::tools::byte_writer& /*buf*/,
+        int /*mode*/)
+    { }
+
+    /*! \brief Number of bytes pack_data(mode) writes, if always the same
+     *
+     * Returning a nonzero size lets the grid allocate the aggregated 
+     * message buffers once and reuse persistent MPI requests; 0 means 
+     * that the size varies and messages are probed every step.
+     */
+    virtual size_t packed_size(int /*mode*/) 
+    { 
+      return 0; 
+    }
+
+    /// counterpart of pack_data; buf holds exactly what pack_data wrote
+    virtual void unpack_data(
+        corgi::tools::byte_reader& /*buf*/,
+        int /*mode*/)
+    { }
+
+
+    /*! \brief Serialize the halo region seen by the neighbor at dir
+     *
+     * Used with exchangeType::HALO. dir is the offset from this tile to 
+     * the (remote) neighbor that reads the region, e.g. {{1,0}} asks for 
+     * the strip next to the +x face. Regions are packed and unpacked in 
+     * the same order on both sides.
+     */
+    virtual void pack_halo(
+        corgi::tools::byte_writer& /*buf*/,
+        int /*mode*/,
+        const corgi::ca::offset_t<D>& /*dir*/)
+    { }
+
+    /// counterpart of pack_halo; reads one region from buf
+    virtual void unpack_halo(
+        corgi::tools::byte_reader& /*buf*/,
+        int /*mode*/,
+        const corgi::ca::offset_t<D>& /*dir*/)
+    { }
+
+    /// number of bytes pack_halo writes for dir if always the same, 0 otherwise
+    virtual size_t halo_size(
+        int /*mode*/,
+        const corgi::ca::offset_t<D>& /*dir*/)
+    { 
+      return 0; 
+    }
+
 
     /// Local computational work estimate for this tile
     virtual double get_work()
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <type_traits>
+
+
+namespace corgi {
+  namespace tools {
+
+
+/// \brief Binary writer that appends into a std::vector<char>
+//
+// Integers can be written as LEB128 varints (7 bits per byte) and signed
+// integers additionally zigzag-coded so that small magnitudes of either
+// sign take only one byte. Everything else is copied bytewise.
+//
+// Alternatively the writer fills a fixed memory region (e.g., a shared
+// memory segment) in place; writing past its end is an error.
+class byte_writer {
+
+  std::vector<char>* _buf = nullptr;
+
+  /// fixed region [_begin, _end) and the write position in it
+  char* _begin = nullptr;
+  char* _ptr   = nullptr;
+  char* _end   = nullptr;
+
+  /// reserve n more bytes and return where they start
+  char* _grow(size_t n)
+  {
+    if(_buf) {
+      size_t len = _buf->size();
+      _buf->resize(len + n);
+      return _buf->data() + len;
+    }
+
+    assert(_ptr + n <= _end);
+    char* ptr = _ptr;
+    _ptr += n;
+    return ptr;
+  }
+
+  public:
+
+  explicit byte_writer(std::vector<char>& buf) :
+    _buf(&buf)
+  { }
+
+  /// write into len bytes of fixed memory starting at ptr
+  byte_writer(char* ptr, size_t len) :
+    _begin(ptr),
+    _ptr(ptr),
+    _end(ptr + len)
+  { }
+
+  /// unsigned varint
+  void put_varint(uint64_t val)
+  {
+    while(val >= 0x80) {
+      *_grow(1) = static_cast<char>( (val & 0x7f) | 0x80 );
+      val >>= 7;
+    }
+    *_grow(1) = static_cast<char>(val);
+  }
+
+  /// signed (zigzag) varint
+  void put_svarint(int64_t val)
+  {
+    put_varint( (static_cast<uint64_t>(val) << 1) ^ static_cast<uint64_t>(val >> 63) );
+  }
+
+  /// raw copy of trivially copyable objects
+  template<typename T>
+  void put(const T* ptr, size_t count)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "type can not be copied bytewise");
+
+    std::memcpy(_grow(count*sizeof(T)), ptr, count*sizeof(T));
+  }
+
+  template<typename T>
+  void put(const T& val) { put(&val, 1); }
+
+  /// number of bytes in the buffer
+  size_t size() const noexcept 
+  { 
+    return _buf ? _buf->size() : static_cast<size_t>(_ptr - _begin); 
+  }
+
+  /// start of the written bytes (e.g., for patching a length prefix)
+  char* data() noexcept { return _buf ? _buf->data() : _begin; }
+};
+
+
+/// \brief Binary reader; counterpart of byte_writer
+class byte_reader {
+
+  const char* _ptr;
+  const char* _end;
+
+  public:
+
+  byte_reader(const char* ptr, size_t len) :
+    _ptr(ptr),
+    _end(ptr + len)
+  { }
+
+  /// unsigned varint
+  uint64_t get_varint()
+  {
+    uint64_t val = 0;
+    for(int shift=0; ; shift += 7) {
+      assert(_ptr < _end);
+      auto byte = static_cast<unsigned char>(*_ptr++);
+      val |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if( (byte & 0x80) == 0 ) break;
+    }
+    return val;
+  }
+
+  /// signed (zigzag) varint
+  int64_t get_svarint()
+  {
+    uint64_t val = get_varint();
+    return static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+  }
+
+  /// raw copy of trivially copyable objects
+  template<typename T>
+  void get(T* ptr, size_t count)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "type can not be copied bytewise");
+    assert(_ptr + count*sizeof(T) <= _end);
+
+    std::memcpy(ptr, _ptr, count*sizeof(T));
+    _ptr += count*sizeof(T);
+  }
+
+  template<typename T>
+  T get()
+  {
+    T val;
+    get(&val, 1);
+    return val;
+  }
+
+  /// split the next len bytes off into a reader of their own
+  byte_reader take(size_t len)
+  {
+    assert(_ptr + len <= _end);
+
+    byte_reader sub(_ptr, len);
+    _ptr += len;
+    return sub;
+  }
+
+  /// bytes left to read
+  size_t remaining() const noexcept { return static_cast<size_t>(_end - _ptr); }
+
+  bool empty() const noexcept { return _ptr >= _end; }
+};
+
+
+  } // end of tools
+} // end of corgi
@@ -16,6 +16,9 @@ class Rotator {
   /// method to add data into the container
   void push_back(T vm) {container.push_back(vm); };
 
+  /// number of stored time steps
+  size_t size() const { return container.size(); };
+
   /// general index
   inline size_t index(size_t i) const {return (i + current_step) % L ; };
 
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "../internals.h"
+
+
+
+namespace corgi {
+  namespace tools {
+
+
+/// \brief Dense contiguous grid
+//
+// Drop-in replacement for sparse_grid that stores every element in one flat
+// std::vector. Element (i,j,k) is found from position
+//
+//    i + L_0*j + L_0*L_1*k
+//
+// which is the same layout that sparse_grid::serialize() produces. Lookups are
+// therefore a single array read and memory consumption is sizeof(T) per element.
+//
+// Iteration mimics the std::map interface of sparse_grid: dereferencing
+// an iterator gives a pair whose .first is the index tuple and .second a
+// reference to the stored value.
+//
+template< typename T, int D>
+class dense_grid {
+
+  public:
+
+  using index_t = corgi::internals::tuple_of<D, size_t>;
+
+  /// storage is one contiguous block that can be handed directly to MPI
+  static constexpr bool is_contiguous = true;
+
+
+  private:
+
+  /// internal data storage
+  std::vector<T> _data;
+
+  /// number of elements in each dimension
+  std::array<size_t, D> _lengths{};
+
+  /// stride of each dimension in the flat storage
+  std::array<size_t, D> _strides{};
+
+
+  /// pre-compute strides and allocate the storage
+  void _allocate()
+  {
+    size_t N = 1;
+    for(size_t i=0; i<D; i++) {
+      _strides[i] = N;
+      N *= _lengths[i];
+    }
+
+    _data.assign(N, T());
+  }
+
+  /// flat location of the element
+  template<size_t... Is>
+  size_t _location(const index_t& ind, std::index_sequence<Is...> /*unused*/) const noexcept
+  {
+    size_t loc = 0;
+    (void)std::initializer_list<int>{
+      ((loc += std::get<Is>(ind)*_strides[Is]), 0)... };
+    return loc;
+  }
+
+  size_t _location(const index_t& ind) const noexcept
+  {
+    return _location(ind, std::make_index_sequence<D>{});
+  }
+
+
+  public:
+
+  /// () referencing
+  template<
+    typename... Dlen,
+    typename = corgi::internals::enable_if_t<(sizeof...(Dlen) == D) &&
+               corgi::internals::are_integral<Dlen...>::value , void>
+  >
+  T& operator()(Dlen... indices)
+  {
+    return _data[ _location( index_t(static_cast<size_t>(indices)...) ) ];
+  }
+
+  T& operator()(const index_t& ind)
+  {
+    return _data[ _location(ind) ];
+  }
+
+
+  /// const () referencing
+  template<
+    typename... Dlen,
+    typename = corgi::internals::enable_if_t<(sizeof...(Dlen) == D) &&
+               corgi::internals::are_integral<Dlen...>::value , void>
+  >
+  const T& operator()(Dlen... indices) const
+  {
+    return _data[ _location( index_t(static_cast<size_t>(indices)...) ) ];
+  }
+
+  const T& operator()(const index_t& ind) const
+  {
+    return _data[ _location(ind) ];
+  }
+
+
+  // ctor with grid size
+  template<
+    typename... Dlen,
+    typename = corgi::internals::enable_if_t<(sizeof...(Dlen) == D) &&
+               corgi::internals::are_integral<Dlen...>::value , void>
+  >
+  dense_grid(Dlen... lens) :
+    _lengths {{ static_cast<size_t>(lens)... }}
+  {
+    _allocate();
+  }
+
+  // ctor without grid size
+  dense_grid() = default;
+
+  dense_grid(const dense_grid& p) = default;
+  dense_grid(dense_grid&& p) noexcept = default;
+  dense_grid& operator= (const dense_grid& other) = default;
+  dense_grid& operator= (dense_grid&& other) noexcept = default;
+
+  virtual ~dense_grid() = default;
+
+
+  /// resize the assumed size; old values are discarded
+  template< typename... Dlen >
+  corgi::internals::enable_if_t<(sizeof...(Dlen) == D) &&
+  corgi::internals::are_integral<Dlen...>::value ,
+    void>
+  resize(Dlen... _lens)
+  {
+    std::array<size_t, D> lens = {{static_cast<size_t>(_lens)...}};
+    _lengths = lens;
+    _allocate();
+  }
+
+  /// total number of elements
+  size_t size() const noexcept { return _data.size(); }
+
+  /// raw pointer to the underlying contiguous storage
+  T*       data()       noexcept { return _data.data(); }
+  const T* data() const noexcept { return _data.data(); }
+
+
+  /// Return object that is contiguous in memory
+  std::vector<T> serialize() const
+  {
+    return _data;
+  }
+
+  void deserialize(const std::vector<T>& vec, std::array<size_t, D> lens)
+  {
+    _lengths = lens;
+    _allocate();
+
+    std::copy_n(vec.begin(), std::min(vec.size(), _data.size()), _data.begin());
+  }
+
+
+  /// reset all values to their default
+  void clear() {
+    std::fill(_data.begin(), _data.end(), T());
+  }
+
+
+  //--------------------------------------------------
+  // iterators
+
+  /// \brief Iterator over (index, value) pairs
+  //
+  // Index tuple is advanced with a carry so that no divisions are needed.
+  template<typename V>
+  class iterator_impl
+  {
+    V* _ptr;
+    const std::array<size_t, D>* _lens;
+    std::array<size_t, D> _ind;
+
+    public:
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::pair<index_t, V&>;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = value_type;
+
+    iterator_impl(V* ptr, const std::array<size_t, D>* lens) :
+      _ptr(ptr),
+      _lens(lens)
+    {
+      _ind.fill(0);
+    }
+
+    value_type operator*() const
+    {
+      return value_type( corgi::internals::into_tuple(_ind), *_ptr );
+    }
+
+    iterator_impl& operator++()
+    {
+      ++_ptr;
+      for(size_t i=0; i<D; i++) {
+        if(++_ind[i] < (*_lens)[i]) break;
+        if(i < D-1) _ind[i] = 0;
+      }
+      return *this;
+    }
+
+    iterator_impl operator++(int)
+    {
+      iterator_impl tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    bool operator==(const iterator_impl& rhs) const { return _ptr == rhs._ptr; }
+    bool operator!=(const iterator_impl& rhs) const { return _ptr != rhs._ptr; }
+  };
+
+  using iterator       = iterator_impl<T>;
+  using const_iterator = iterator_impl<const T>;
+
+  iterator begin()
+  {
+    return iterator(_data.data(), &_lengths);
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(_data.data(), &_lengths);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(_data.data(), &_lengths);
+  }
+
+  iterator end()
+  {
+    return iterator(_data.data() + _data.size(), &_lengths);
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(_data.data() + _data.size(), &_lengths);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(_data.data() + _data.size(), &_lengths);
+  }
+
+};
+
+
+
+  } // end of tools
+} // end of corgi
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <mpi.h>
+
+
+namespace corgi {
+  namespace tools {
+
+
+/// \brief Exchange byte messages with a set of ranks that is not known
+//  by the receivers in advance
+//
+// Non-blocking consensus (NBX, Hoefler et al. 2010): every message goes
+// out as a synchronous Issend; once all of them have been matched the
+// rank enters a non-blocking barrier and keeps receiving until the
+// barrier completes. on_recv(orig, bytes) is called for every incoming
+// message. No counts are exchanged beforehand.
+//
+// NOTE: a rank can leave the barrier while others still probe; consecutive
+// rounds must therefore alternate between (at least) two tags.
+template<typename F>
+void sparse_exchange(
+    MPI_Comm comm,
+    int tag,
+    const std::map<int, std::vector<char>>& outgoing,
+    F&& on_recv)
+{
+  std::vector<MPI_Request> sends;
+  sends.reserve(outgoing.size());
+
+  for(auto& elem : outgoing) {
+    if(elem.second.empty()) continue;
+
+    sends.emplace_back();
+    MPI_Issend(elem.second.data(), static_cast<int>(elem.second.size()),
+        MPI_BYTE, elem.first, tag, comm, &sends.back());
+  }
+
+  std::vector<char> buf;
+  MPI_Request barrier = MPI_REQUEST_NULL;
+  bool in_barrier = false;
+
+  while(true) {
+    int flag = 0;
+    MPI_Message msg;
+    MPI_Status status;
+    MPI_Improbe(MPI_ANY_SOURCE, tag, comm, &flag, &msg, &status);
+
+    if(flag) {
+      int count = 0;
+      MPI_Get_count(&status, MPI_BYTE, &count);
+      buf.resize(count);
+      MPI_Mrecv(buf.data(), count, MPI_BYTE, &msg, MPI_STATUS_IGNORE);
+
+      on_recv(status.MPI_SOURCE, buf);
+    }
+
+    if(in_barrier) {
+      int done = 0;
+      MPI_Test(&barrier, &done, MPI_STATUS_IGNORE);
+      if(done) break;
+    } else {
+      int sent = 0;
+      MPI_Testall(static_cast<int>(sends.size()), sends.data(), &sent, MPI_STATUSES_IGNORE);
+      if(sent) {
+        MPI_Ibarrier(comm, &barrier);
+        in_barrier = true;
+      }
+    }
+  }
+}
+
+
+  } // end of tools
+} // end of corgi
@@ -135,6 +135,11 @@ class sparse_grid {
 
   using map_t = std::map< corgi::internals::tuple_of<D, size_t>, T>;
 
+  public:
+
+  /// data needs to be serialized before handing it to MPI
+  static constexpr bool is_contiguous = false;
+
 
   private:
 
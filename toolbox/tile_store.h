@@ -0,0 +1,267 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <utility>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include <unordered_map>
+
+
+namespace corgi {
+  namespace tools {
+
+
+/// \brief Tile container with stable slots
+//
+// Tiles are stored in a flat vector of slots and addressed by a dense
+// local handle (= slot number). Handles of live tiles never change; slots
+// of erased tiles are put into a free list and recycled by later insertions.
+// A hash map translates the global tile ID (cid) into a handle in O(1).
+//
+// Next to the owning shared pointers a parallel array of raw pointers is
+// kept so that hot loops can walk the tiles in slot order, or fetch
+// them by handle, without touching any reference counts.
+//
+// For backwards compatibility the container also mimics the subset of the
+// std::unordered_map<cid, shared_ptr> interface that the grid used to expose
+// (count, find, at, emplace, erase, range-for over (cid, ptr) pairs).
+//
+template<typename T>
+class tile_store {
+
+  public:
+
+  using key_type    = uint64_t;
+  using pointer     = std::shared_ptr<T>;
+  using value_type  = std::pair<key_type, pointer>;
+  using handle_type = size_t;
+
+  /// handle value of non-existing tiles
+  static constexpr handle_type npos = std::numeric_limits<handle_type>::max();
+
+
+  private:
+
+  /// (cid, owning pointer) of each slot; pointer is empty for free slots
+  std::vector<value_type> _slots;
+
+  /// raw pointer of each slot; nullptr for free slots
+  std::vector<T*> _ptrs;
+
+  /// recycled slots
+  std::vector<handle_type> _free;
+
+  /// cid -> handle
+  std::unordered_map<key_type, handle_type> _handles;
+
+
+  public:
+
+  //--------------------------------------------------
+  // iterators
+
+  /// \brief Iterator over occupied slots in memory order
+  template<typename V>
+  class iterator_impl
+  {
+    V* _ptr;
+    V* _end;
+
+    void _skip_free()
+    {
+      while(_ptr != _end && !_ptr->second) ++_ptr;
+    }
+
+    public:
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = typename std::remove_const<V>::type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = V*;
+    using reference         = V&;
+
+    iterator_impl(V* ptr, V* end) :
+      _ptr(ptr),
+      _end(end)
+    {
+      _skip_free();
+    }
+
+    reference operator*()  const { return *_ptr; }
+    pointer   operator->() const { return  _ptr; }
+
+    iterator_impl& operator++()
+    {
+      ++_ptr;
+      _skip_free();
+      return *this;
+    }
+
+    iterator_impl operator++(int)
+    {
+      iterator_impl tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    bool operator==(const iterator_impl& rhs) const { return _ptr == rhs._ptr; }
+    bool operator!=(const iterator_impl& rhs) const { return _ptr != rhs._ptr; }
+  };
+
+  // NOTE: slots are handed out as const so that cids can not be modified
+  // from the outside; tiles themselves are still mutable through the pointer.
+  using iterator       = iterator_impl<const value_type>;
+  using const_iterator = iterator_impl<const value_type>;
+
+  iterator begin() const
+  {
+    return iterator(_slots.data(), _slots.data() + _slots.size());
+  }
+
+  iterator end() const
+  {
+    return iterator(_slots.data() + _slots.size(), _slots.data() + _slots.size());
+  }
+
+
+  //--------------------------------------------------
+  // handle based access
+
+  /// handle of the tile; npos if not found
+  handle_type handle(const key_type cid) const
+  {
+    auto it = _handles.find(cid);
+    return it == _handles.end() ? npos : it->second;
+  }
+
+  /// raw pointer to tile; nullptr if not found
+  T* get(const key_type cid) const
+  {
+    auto it = _handles.find(cid);
+    return it == _handles.end() ? nullptr : _ptrs[it->second];
+  }
+
+  /// raw pointer to tile in the slot; nullptr if slot is free
+  T* slot(const handle_type h) const noexcept { return _ptrs[h]; }
+
+  /// cid of the tile in the slot
+  key_type slot_id(const handle_type h) const noexcept { return _slots[h].first; }
+
+  /// contiguous array of raw tile pointers (with nullptr holes)
+  T* const* data() const noexcept { return _ptrs.data(); }
+
+  /// number of slots (occupied and free)
+  size_t slots() const noexcept { return _slots.size(); }
+
+  /// number of stored tiles
+  size_t size() const noexcept { return _handles.size(); }
+
+  bool empty() const noexcept { return _handles.empty(); }
+
+  void reserve(size_t n)
+  {
+    _slots.reserve(n);
+    _ptrs.reserve(n);
+    _handles.reserve(n);
+  }
+
+
+  //--------------------------------------------------
+  // modifiers
+
+  /// insert tile if cid does not exist yet; returns handle and success flag
+  std::pair<handle_type, bool> insert(const key_type cid, pointer tileptr)
+  {
+    auto it = _handles.find(cid);
+    if(it != _handles.end()) return {it->second, false};
+
+    handle_type h;
+    if(!_free.empty()) {
+      h = _free.back();
+      _free.pop_back();
+    } else {
+      h = _slots.size();
+      _slots.emplace_back();
+      _ptrs.push_back(nullptr);
+    }
+
+    _ptrs[h]  = tileptr.get();
+    _slots[h] = value_type(cid, std::move(tileptr));
+    _handles.emplace(cid, h);
+
+    return {h, true};
+  }
+
+  /// insert tile or replace existing one in-place (keeping its handle)
+  handle_type insert_or_assign(const key_type cid, pointer tileptr)
+  {
+    auto it = _handles.find(cid);
+    if(it == _handles.end()) return insert(cid, std::move(tileptr)).first;
+
+    handle_type h = it->second;
+    _ptrs[h] = tileptr.get();
+    _slots[h].second = std::move(tileptr);
+    return h;
+  }
+
+  /// remove tile; returns number of removed tiles (0 or 1)
+  size_t erase(const key_type cid)
+  {
+    auto it = _handles.find(cid);
+    if(it == _handles.end()) return 0;
+
+    handle_type h = it->second;
+    _handles.erase(it);
+
+    _slots[h].second.reset();
+    _ptrs[h] = nullptr;
+    _free.push_back(h);
+
+    return 1;
+  }
+
+  void clear()
+  {
+    _slots.clear();
+    _ptrs.clear();
+    _free.clear();
+    _handles.clear();
+  }
+
+
+  //--------------------------------------------------
+  // std::unordered_map compatibility
+
+  size_t count(const key_type cid) const { return _handles.count(cid); }
+
+  iterator find(const key_type cid) const
+  {
+    auto it = _handles.find(cid);
+    if(it == _handles.end()) return end();
+
+    return iterator(_slots.data() + it->second, _slots.data() + _slots.size());
+  }
+
+  const pointer& at(const key_type cid) const
+  {
+    auto it = _handles.find(cid);
+    if(it == _handles.end()) throw std::out_of_range("tile entry not found");
+
+    return _slots[it->second].second;
+  }
+
+  std::pair<iterator, bool> emplace(const key_type cid, pointer tileptr)
+  {
+    auto ret = insert(cid, std::move(tileptr));
+    return { iterator(_slots.data() + ret.first, _slots.data() + _slots.size()), ret.second };
+  }
+
+};
+
+
+  } // end of tools
+} // end of corgi